@@ -33,6 +33,30 @@
 #include <thread>
 #include <utility>
 #include <mutex>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
+#include <charconv>
+#include <condition_variable>
+#include <map>
+#include <array>
+#include <random>
+#include <unordered_set>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
 
 std::recursive_mutex coutLock;//to make sure separate threads don't call std::cout simultaneously
 
@@ -445,6 +469,740 @@ int operator!=(aTime& t1, aTime& t2){
                 return (! (t1==t2) );}
 
 
+
+//asynchronous console logging, so worker threads never wait on console i/o.
+//each thread writes records into its own single-producer ring buffer (no locks; if the ring is full the
+//record is dropped and counted), and a background thread drains all the rings, in the order the records
+//were made, to std::cout or std::cerr.  coutLock is then only held by whoever is actually writing.
+//repeated diagnostics are rate limited at the call site with a static LogRateLimit
+enum logSeverity {logDebug=0,logInfo=1,logWarning=2,logError=3};
+
+class LogRecord{
+    public:
+        uint64_t sequence_;
+        logSeverity severity_;
+        bool toStderr_;
+        std::string text_;
+        
+    public:
+        LogRecord(void):sequence_(0),severity_(logInfo),toStderr_(false){}
+    };
+
+
+class LogRing{//written only by the owning thread, read only by whoever holds AsyncLogger::drainLock_
+    public:
+        std::vector<LogRecord> records_;
+        std::atomic<uint64_t> head_, tail_;//next slot to write, next slot to read
+        std::atomic<bool> ownerExited_;
+        
+    public:
+        LogRing(unsigned long capacity):records_(capacity),head_(0),tail_(0),ownerExited_(false){}
+        
+        bool Push(LogRecord& rec){
+            uint64_t h=head_.load(std::memory_order_relaxed);
+            if(h-tail_.load(std::memory_order_acquire)>=records_.size()) return false;//full
+            records_[h%records_.size()]=std::move(rec);
+            head_.store(h+1,std::memory_order_release);
+            return true;}
+        
+        bool Pop(LogRecord& rec){
+            uint64_t t=tail_.load(std::memory_order_relaxed);
+            if(t==head_.load(std::memory_order_acquire)) return false;
+            rec=std::move(records_[t%records_.size()]);
+            tail_.store(t+1,std::memory_order_release);
+            return true;}
+        
+        bool Empty(void){
+            return tail_.load(std::memory_order_acquire)==head_.load(std::memory_order_acquire);}
+    };//class LogRing
+
+
+class LogRingHolder{//one per thread; lets the drain thread know when a ring can be thrown away
+    public:
+        std::shared_ptr<LogRing> ring_;
+        ~LogRingHolder(void){
+            if(ring_){ring_->ownerExited_=true;}}
+    };
+thread_local LogRingHolder threadLogRing;
+
+
+class LogRateLimit{//lets the first firstN_ occurrences through, then every everyN_-th one
+    public:
+        uint64_t firstN_, everyN_;
+        std::atomic<uint64_t> count_;
+        
+    public:
+        LogRateLimit(uint64_t firstN, uint64_t everyN):firstN_(firstN),everyN_(everyN),count_(0){}
+        
+        bool Allow(uint64_t& occurrence){
+            occurrence=count_.fetch_add(1,std::memory_order_relaxed)+1;
+            return (occurrence<=firstN_ || (everyN_>0 && occurrence%everyN_==0));}
+    };
+
+
+class AsyncLogger{
+    public:
+        logSeverity minSeverity_;
+        unsigned long ringCapacity_;
+        std::atomic<uint64_t> sequence_;
+        std::atomic<bool> running_;
+        std::mutex registryLock_;//guards rings_
+        std::vector<std::shared_ptr<LogRing> > rings_;
+        std::mutex drainLock_;//only one drainer at a time
+        std::thread drainThread_;
+        std::atomic<uint64_t> dropped_;//records lost to full rings
+        uint64_t droppedReported_;
+        
+    public:
+        AsyncLogger(void):minSeverity_(logInfo),ringCapacity_(1024),sequence_(0),running_(false),dropped_(0),droppedReported_(0){}
+        
+        ~AsyncLogger(void){Stop();}
+        
+    public:
+        void Start(void){
+            if(running_) return;
+            running_=true;
+            drainThread_=std::thread([this](){
+                while(running_){
+                    Drain();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));}
+                });
+            }
+        
+        void Stop(void){//drains everything; anything logged afterwards is written directly
+            if(!running_) return;
+            running_=false;
+            drainThread_.join();
+            Drain();}
+        
+        void Log(logSeverity severity, std::string text, bool toStderr=false){
+            if(severity<minSeverity_) return;
+            LogRecord rec;
+            rec.sequence_=sequence_.fetch_add(1,std::memory_order_relaxed);
+            rec.severity_=severity; rec.toStderr_=toStderr; rec.text_=text;
+            if(!running_){
+                coutLock.lock(); Write(rec); coutLock.unlock();
+                return;}
+            if(!threadLogRing.ring_){//first record from this thread
+                threadLogRing.ring_=std::make_shared<LogRing>(ringCapacity_);
+                std::lock_guard<std::mutex> lock(registryLock_);
+                rings_.push_back(threadLogRing.ring_);}
+            if(!threadLogRing.ring_->Push(rec)){
+                dropped_.fetch_add(1,std::memory_order_relaxed);}
+            }
+        
+        void Drain(void){
+            std::lock_guard<std::mutex> drain(drainLock_);
+            std::vector<std::shared_ptr<LogRing> > rings;
+            {std::lock_guard<std::mutex> lock(registryLock_); rings=rings_;}
+            std::vector<LogRecord> records;
+            for(unsigned long r=0;r<rings.size();++r){
+                LogRecord rec;
+                while(rings[r]->Pop(rec)){
+                    records.push_back(rec);}
+                }//r
+            std::sort(records.begin(),records.end(),
+                    [](const LogRecord& a, const LogRecord& b){return a.sequence_<b.sequence_;});
+            uint64_t dropped=dropped_.load(std::memory_order_relaxed);
+            coutLock.lock();
+            for(unsigned long i=0;i<records.size();++i){
+                Write(records[i]);}
+            if(dropped>droppedReported_){
+                std::cerr<<"warning: "<<dropped-droppedReported_<<" log records dropped (ring buffer full)"<<std::endl;
+                droppedReported_=dropped;}
+            coutLock.unlock();
+            {std::lock_guard<std::mutex> lock(registryLock_);//forget rings whose threads are gone
+                for(unsigned long r=0;r<rings_.size();){
+                    if(rings_[r]->ownerExited_ && rings_[r]->Empty()){
+                            rings_.erase(rings_.begin()+r);}
+                        else{++r;}
+                    }//r
+                }
+            }//Drain
+        
+        void Write(LogRecord& rec){//caller holds coutLock
+            std::ostream& out = rec.toStderr_ ? std::cerr : std::cout;
+            if(rec.severity_==logWarning){out<<"warning: ";}
+            if(rec.severity_==logError){out<<"error: ";}
+            out<<rec.text_<<std::endl;}
+    };//class AsyncLogger
+
+AsyncLogger logger;//started in main()
+
+
+
+class BufferedTableWriter{
+    //formats table rows into large buffers (numbers via std::to_chars, in the same %g form, 6 significant digits,
+    //that ostream<< gives) and hands full buffers to a background thread that writes them out,
+    //so writing a big table doesn't hold up the search. without Start() full buffers are written inline
+    public:
+        std::ostream* out_;
+        std::string buffer_;
+        unsigned long bufferCapacity_;
+        unsigned long maxQueued_;//the caller waits when this many full buffers are waiting to be written
+        std::vector<std::string> queue_;
+        bool writing_;//the I/O thread holds a buffer it took off queue_
+        bool running_;
+        std::mutex queueLock_;
+        std::condition_variable queueChanged_;
+        std::thread ioThread_;
+    
+    public:
+        BufferedTableWriter(std::ostream& out):out_(&out),bufferCapacity_(1<<20),maxQueued_(8),writing_(false),running_(false){
+            buffer_.reserve(bufferCapacity_+1024);}
+        
+        ~BufferedTableWriter(void){Stop();}
+    
+    public:
+        void Start(void){
+            if(running_) return;
+            running_=true;
+            ioThread_=std::thread([this](){
+                std::unique_lock<std::mutex> lock(queueLock_);
+                while(running_ || !queue_.empty()){
+                    if(queue_.empty()){
+                        queueChanged_.wait(lock);
+                        continue;}
+                    std::string buf;
+                    buf.swap(queue_.front());
+                    queue_.erase(queue_.begin());
+                    writing_=true;
+                    lock.unlock();
+                    queueChanged_.notify_all();
+                    out_->write(buf.data(),buf.size());
+                    lock.lock();
+                    writing_=false;
+                    queueChanged_.notify_all();}
+                });
+            }
+        
+        void Stop(void){//writes everything still buffered
+            Flush();
+            if(!running_) return;
+            {std::lock_guard<std::mutex> lock(queueLock_); running_=false;}
+            queueChanged_.notify_all();
+            ioThread_.join();}
+        
+        void Flush(void){//returns once everything so far has reached out_
+            HandOff();
+            if(running_){
+                std::unique_lock<std::mutex> lock(queueLock_);
+                queueChanged_.wait(lock,[this](){return queue_.empty() && !writing_;});}
+            out_->flush();}
+        
+        void Append(const std::string& text){buffer_+=text;}
+        void Append(const char* text){buffer_+=text;}
+        void Append(char c){buffer_+=c;}
+        
+        void Number(long double val){
+            char digits[64];
+            std::to_chars_result res=std::to_chars(digits,digits+sizeof(digits),val,std::chars_format::general,6);
+            buffer_.append(digits,res.ptr);}
+        
+        void Number(double val){
+            char digits[64];
+            std::to_chars_result res=std::to_chars(digits,digits+sizeof(digits),val,std::chars_format::general,6);
+            buffer_.append(digits,res.ptr);}
+        
+        void Integer(long long val){
+            char digits[24];
+            std::to_chars_result res=std::to_chars(digits,digits+sizeof(digits),val);
+            buffer_.append(digits,res.ptr);}
+        
+        void EndRow(void){
+            buffer_+='\n';
+            if(buffer_.size()>=bufferCapacity_){
+                HandOff();}
+            }
+        
+        void HandOff(void){
+            if(buffer_.empty()) return;
+            if(!running_){
+                out_->write(buffer_.data(),buffer_.size());
+                buffer_.clear();
+                return;}
+            std::string full;
+            full.reserve(bufferCapacity_+1024);
+            full.swap(buffer_);
+            std::unique_lock<std::mutex> lock(queueLock_);
+            queueChanged_.wait(lock,[this](){return queue_.size()<maxQueued_;});
+            queue_.push_back(std::move(full));
+            lock.unlock();
+            queueChanged_.notify_all();}
+    };//class BufferedTableWriter
+
+
+
+//lightweight counters for the hot paths of a sweep, so a slow Popt can be diagnosed.
+//each thread counts into its own thread_local copy (threadRunStatistics) so there's no locking
+//in the inner loops; a worker thread's copy is folded into runStatisticsTotal when the thread exits,
+//and main() collects the total after each Popt with CollectRunStatistics()
+class RunStatistics{
+    public:
+        uint64_t referenceGtypes_;//reference genotypes visited
+        uint64_t doubleHets_, tfHets_, cisHets_, homozygotes_;//branch taken for each reference genotype
+        uint64_t amoebaCalls_, amoebaIterations_, amoebaNonConvergence_;
+        uint64_t addSolutionCalls_;
+        uint64_t ties_, newMaxima_;//wBar equal to, or better than, the running maximum
+        uint64_t prunedGtypes_;//skipped because no genotype they make is near enough to Popt (PhenotypeIndex)
+        bool foldOnExit_;//true for the thread_local copies
+        
+    public:
+        RunStatistics(bool foldOnExit=false):foldOnExit_(foldOnExit){Reset();}
+        
+        RunStatistics(const RunStatistics& rs){
+            *this=rs;}
+        
+        ~RunStatistics(void);
+        
+        RunStatistics& operator=(const RunStatistics& rs){
+            referenceGtypes_=rs.referenceGtypes_;
+            doubleHets_=rs.doubleHets_; tfHets_=rs.tfHets_; cisHets_=rs.cisHets_; homozygotes_=rs.homozygotes_;
+            amoebaCalls_=rs.amoebaCalls_; amoebaIterations_=rs.amoebaIterations_;
+            amoebaNonConvergence_=rs.amoebaNonConvergence_;
+            addSolutionCalls_=rs.addSolutionCalls_;
+            ties_=rs.ties_; newMaxima_=rs.newMaxima_;
+            prunedGtypes_=rs.prunedGtypes_;
+            foldOnExit_=false;//only the thread_local original folds itself into the total
+            return *this;}
+        
+    public:
+        void Reset(void){
+            referenceGtypes_=doubleHets_=tfHets_=cisHets_=homozygotes_=0;
+            amoebaCalls_=amoebaIterations_=amoebaNonConvergence_=0;
+            addSolutionCalls_=ties_=newMaxima_=0;
+            prunedGtypes_=0;}
+        
+        void Add(const RunStatistics& rs){
+            referenceGtypes_+=rs.referenceGtypes_;
+            doubleHets_+=rs.doubleHets_; tfHets_+=rs.tfHets_; cisHets_+=rs.cisHets_; homozygotes_+=rs.homozygotes_;
+            amoebaCalls_+=rs.amoebaCalls_; amoebaIterations_+=rs.amoebaIterations_;
+            amoebaNonConvergence_+=rs.amoebaNonConvergence_;
+            addSolutionCalls_+=rs.addSolutionCalls_;
+            ties_+=rs.ties_; newMaxima_+=rs.newMaxima_;
+            prunedGtypes_+=rs.prunedGtypes_;}
+        
+        void Print(std::ostream& out){
+            out<<"reference g'types = "<<referenceGtypes_;
+            out<<" (double het "<<doubleHets_<<", TF het "<<tfHets_<<", cis het "<<cisHets_;
+            out<<", homozygote "<<homozygotes_<<")"<<std::endl;
+            out<<"amoeba calls = "<<amoebaCalls_<<", iterations = "<<amoebaIterations_;
+            out<<", not converged = "<<amoebaNonConvergence_<<std::endl;
+            out<<"AddSolution calls = "<<addSolutionCalls_<<", ties = "<<ties_<<", new maxima = "<<newMaxima_<<std::endl;
+            if(prunedGtypes_>0){
+                out<<"reference g'types skipped by phenotype = "<<prunedGtypes_<<std::endl;}
+            }
+        };//class RunStatistics
+
+std::mutex runStatisticsLock;
+RunStatistics runStatisticsTotal;//what finished threads have counted since the last CollectRunStatistics()
+thread_local RunStatistics threadRunStatistics(true);
+
+RunStatistics::~RunStatistics(void){
+    if(foldOnExit_){
+        std::lock_guard<std::mutex> lock(runStatisticsLock);
+        runStatisticsTotal.Add(*this);}
+    }
+
+RunStatistics CollectRunStatistics(void){
+    //call from main() between Popts, when no worker threads are running;
+    //returns everything counted since the last call, including the calling thread's own counts
+    std::lock_guard<std::mutex> lock(runStatisticsLock);
+    RunStatistics rs(runStatisticsTotal);
+    rs.Add(threadRunStatistics);
+    runStatisticsTotal.Reset(); threadRunStatistics.Reset();
+    return rs;}
+
+
+
+//periodic progress records for long sweeps, written to stderr and (overwriting) to a status file.
+//progress is counted in reference genotypes, using the exact size of the triangular loop space
+//in MaximizeUsingBitstringsThreadableAllCis / MaximizeUsingBitstrings:
+//  dosageVal0 in [lowTf0,highTf0]; tfVal0 in [0,N); dosageVal1 in [0,dosageVal0] ([0,N) if splitSinglePoptRun);
+//  tfVal1 in [0,tfVal0]; cisVal0 in [0,N); cisVal1 in [0,cisVal0]
+//counts are exact for bitstringLen<=11 (beyond that they overflow uint64_t)
+class SweepProgress{
+    public:
+        bool enabled_;
+        long double intervalSeconds_;//0 means only report at the end of each Popt
+        std::string statusFileName_;
+        long double Popt_;
+        uint64_t maxBitstringVal_, lowTf0_, highTf0_;
+        bool splitSinglePoptRun_;
+        uint64_t totalGtypes_, gtypesDone_;
+        std::chrono::steady_clock::time_point start_, lastReport_;
+        
+    public:
+        SweepProgress(void):enabled_(false),intervalSeconds_(60),Popt_(zero),maxBitstringVal_(0),lowTf0_(0),highTf0_(0),
+                splitSinglePoptRun_(false),totalGtypes_(0),gtypesDone_(0){}
+        
+        ~SweepProgress(void){}
+        
+    public:
+        uint64_t pairsBelow(uint64_t n){//unordered pairs (x0,x1) with x1<=x0<n
+            return n*(n+1)/2;}
+        
+        uint64_t dosagePairsBefore(uint64_t dosageVal0){//(dosageVal0,dosageVal1) pairs visited before this dosageVal0
+            if(splitSinglePoptRun_){
+                return (dosageVal0-lowTf0_)*maxBitstringVal_;}
+            return pairsBelow(dosageVal0)-pairsBelow(lowTf0_);}
+        
+        uint64_t gtypesThrough(uint64_t dosageVal0, uint64_t tfVal0){//reference g'types done once tfVal0 is finished
+            uint64_t dosageVal1s = splitSinglePoptRun_ ? maxBitstringVal_ : dosageVal0+1;
+            uint64_t cisPairs=pairsBelow(maxBitstringVal_);
+            return (dosagePairsBefore(dosageVal0)*pairsBelow(maxBitstringVal_) + dosageVal1s*pairsBelow(tfVal0+1))*cisPairs;}
+        
+        void Start(long double Popt, uint64_t maxBitstringVal, bool splitSinglePoptRun, uint64_t lowTf0, uint64_t highTf0){
+            Popt_=Popt; maxBitstringVal_=maxBitstringVal; splitSinglePoptRun_=splitSinglePoptRun;
+            lowTf0_=lowTf0; highTf0_=highTf0;
+            totalGtypes_=gtypesThrough(highTf0,maxBitstringVal-1);
+            gtypesDone_=0;
+            start_=lastReport_=std::chrono::steady_clock::now();}
+        
+        void Update(uint64_t dosageVal0, uint64_t tfVal0, long double wBarMax){//call after each tfVal0 is finished
+            if(!enabled_) return;
+            gtypesDone_=gtypesThrough(dosageVal0,tfVal0);
+            ReportIfDue(wBarMax);}
+        
+        void Add(uint64_t dosageVal0, uint64_t tfVal0, long double wBarMax){//as Update, for sweeps that aren't in numeric order
+            if(!enabled_) return;
+            uint64_t dosageVal1s = splitSinglePoptRun_ ? maxBitstringVal_ : dosageVal0+1;
+            gtypesDone_+=dosageVal1s*(tfVal0+1)*pairsBelow(maxBitstringVal_);
+            ReportIfDue(wBarMax);}
+        
+        void ReportIfDue(long double wBarMax){
+            std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now();
+            bool finished=(gtypesDone_>=totalGtypes_);
+            if(!finished && (intervalSeconds_<=zero
+                    || std::chrono::duration<long double>(now-lastReport_).count()<intervalSeconds_)) return;
+            lastReport_=now;
+            Report(wBarMax);}
+        
+        void Report(long double wBarMax){
+            long double seconds=std::chrono::duration<long double>(std::chrono::steady_clock::now()-start_).count();
+            long double fractionDone = totalGtypes_>0 ? (long double)gtypesDone_/(long double)totalGtypes_ : one;
+            long double rate = seconds>zero ? (long double)gtypesDone_/seconds : zero;
+            long double secondsLeft = rate>zero ? (long double)(totalGtypes_-gtypesDone_)/rate : zero;
+            aTime clock;
+            std::string *remaining=clock.HMS(ROUND(secondsLeft,0));
+            std::string *eta=clock.localTimeAtMoment(clock.now()+(time_t)secondsLeft);
+            std::stringstream record;
+            record<<"progress Popt="<<Popt_;
+            if(splitSinglePoptRun_){
+                record<<" (tf0 dosage "<<lowTf0_<<" to "<<highTf0_<<")";}
+            record<<": "<<ROUND(100*fractionDone,2)<<"% ("<<gtypesDone_<<" of "<<totalGtypes_<<" g'types)";
+            record<<", "<<ROUND(rate,1)<<" g'types/s, "<<*remaining<<" remaining, done at "<<*eta;
+            record<<", wBarMax="<<wBarMax;
+            delete remaining; delete eta;
+            logger.Log(logInfo,record.str(),true);
+            if(statusFileName_.length()>0){
+                std::fstream statusFile(statusFileName_.c_str(),std::fstream::out);//overwrites
+                statusFile<<record.str()<<std::endl;
+                statusFile.close();}
+            }//Report
+        };//class SweepProgress
+
+SweepProgress sweepProgress;//configured in main()
+
+
+
+//optional per-phase profiling (--profile, and --perf-counters for hardware counters on linux).
+//phase times come from steady_clock and are summed over threads, so with several threads running
+//they can add up to more than the wall time.  like RunStatistics, each thread accumulates into its
+//own thread_local copy, which is folded into phaseProfileTotal when the thread exits
+enum profiledPhase {phenotypePhase=0,landscapePhase=1,bookkeepingPhase=2,outputPhase=3,numProfiledPhases=4};
+enum hardwareCounter {cyclesCounter=0,instructionsCounter=1,cacheMissesCounter=2,branchMissesCounter=3,numHardwareCounters=4};
+
+bool phaseProfilingEnabled=false;//set in main()
+bool hardwareCountersEnabled=false;//set in main(); needs phaseProfilingEnabled too
+
+class PhaseProfile{
+    public:
+        long double seconds_[numProfiledPhases];
+        uint64_t calls_[numProfiledPhases];
+        uint64_t counts_[numProfiledPhases][numHardwareCounters];
+        bool countersRead_;//true once any thread has read the hardware counters
+        bool foldOnExit_;//true for the thread_local copies
+        
+        //per-thread working state; not copied
+        int depth_[numProfiledPhases];//so nested Begin/End pairs for the same phase only count once
+        std::chrono::steady_clock::time_point startTime_[numProfiledPhases];
+        uint64_t startCounts_[numProfiledPhases][numHardwareCounters];
+        int perfFd_[numHardwareCounters];//perfFd_[0] leads the group
+        int perfState_;//0 not opened yet, 1 open, -1 opening failed
+        
+    public:
+        PhaseProfile(bool foldOnExit=false):foldOnExit_(foldOnExit),perfState_(0){
+            Reset();
+            for(int ph=0;ph<numProfiledPhases;++ph){depth_[ph]=0;}
+            }
+        
+        PhaseProfile(const PhaseProfile& pp):perfState_(0){
+            *this=pp;
+            for(int ph=0;ph<numProfiledPhases;++ph){depth_[ph]=0;}
+            }
+        
+        ~PhaseProfile(void);
+        
+        PhaseProfile& operator=(const PhaseProfile& pp){
+            for(int ph=0;ph<numProfiledPhases;++ph){
+                seconds_[ph]=pp.seconds_[ph]; calls_[ph]=pp.calls_[ph];
+                for(int c=0;c<numHardwareCounters;++c){counts_[ph][c]=pp.counts_[ph][c];}
+                }
+            countersRead_=pp.countersRead_;
+            foldOnExit_=false;//only the thread_local original folds itself into the total
+            return *this;}
+        
+    public:
+        void Reset(void){
+            for(int ph=0;ph<numProfiledPhases;++ph){
+                seconds_[ph]=zero; calls_[ph]=0;
+                for(int c=0;c<numHardwareCounters;++c){counts_[ph][c]=0;}
+                }
+            countersRead_=false;}
+        
+        void Add(const PhaseProfile& pp){
+            for(int ph=0;ph<numProfiledPhases;++ph){
+                seconds_[ph]+=pp.seconds_[ph]; calls_[ph]+=pp.calls_[ph];
+                for(int c=0;c<numHardwareCounters;++c){counts_[ph][c]+=pp.counts_[ph][c];}
+                }
+            countersRead_ = countersRead_ || pp.countersRead_;}
+        
+        inline void Begin(profiledPhase ph){
+            if(!phaseProfilingEnabled) return;
+            if(depth_[ph]++>0) return;
+            if(hardwareCountersEnabled){
+                ReadHardwareCounters(startCounts_[ph]);}
+            startTime_[ph]=std::chrono::steady_clock::now();
+            }
+        
+        inline void End(profiledPhase ph){
+            if(!phaseProfilingEnabled || depth_[ph]==0) return;
+            if(--depth_[ph]>0) return;
+            seconds_[ph]+=std::chrono::duration<long double>(std::chrono::steady_clock::now()-startTime_[ph]).count();
+            calls_[ph]++;
+            uint64_t nowCounts[numHardwareCounters];
+            if(hardwareCountersEnabled && ReadHardwareCounters(nowCounts)){
+                for(int c=0;c<numHardwareCounters;++c){counts_[ph][c]+=nowCounts[c]-startCounts_[ph][c];}
+                countersRead_=true;}
+            }
+        
+        bool ReadHardwareCounters(uint64_t values[numHardwareCounters]);//false if they can't be read
+        
+        void Print(std::ostream& out){
+            const char* phaseName[numProfiledPhases]={"phenotype","landscape solve","bookkeeping","output"};
+            for(int ph=0;ph<numProfiledPhases;++ph){
+                out<<"  "<<phaseName[ph]<<": "<<seconds_[ph]<<" s in "<<calls_[ph]<<" calls";
+                if(countersRead_){
+                    out<<"; cycles "<<counts_[ph][cyclesCounter]<<", instructions "<<counts_[ph][instructionsCounter];
+                    if(counts_[ph][cyclesCounter]>0){
+                        out<<" (IPC "<<ROUND((long double)counts_[ph][instructionsCounter]/(long double)counts_[ph][cyclesCounter],2)<<")";}
+                    out<<", cache misses "<<counts_[ph][cacheMissesCounter];
+                    out<<", branch misses "<<counts_[ph][branchMissesCounter];}
+                out<<std::endl;
+                }//ph
+            }//Print
+        };//class PhaseProfile
+
+std::mutex phaseProfileLock;
+PhaseProfile phaseProfileTotal;//what finished threads have accumulated since the last CollectPhaseProfile()
+thread_local PhaseProfile threadPhaseProfile(true);
+
+bool PhaseProfile::ReadHardwareCounters(uint64_t values[numHardwareCounters]){
+#ifdef __linux__
+    if(perfState_==-1) return false;
+    if(perfState_==0){//open a counter group for this thread; cycles leads the group
+        static const uint64_t config[numHardwareCounters]={PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES,PERF_COUNT_HW_BRANCH_MISSES};
+        for(int c=0;c<numHardwareCounters;++c){
+            struct perf_event_attr pe;
+            memset(&pe,0,sizeof(pe));
+            pe.type=PERF_TYPE_HARDWARE;
+            pe.size=sizeof(pe);
+            pe.config=config[c];
+            pe.disabled=(c==0);
+            pe.exclude_kernel=1;
+            pe.exclude_hv=1;
+            pe.read_format=PERF_FORMAT_GROUP;
+            perfFd_[c]=(int)syscall(__NR_perf_event_open,&pe,0,-1,(c==0 ? -1 : perfFd_[0]),0);
+            if(perfFd_[c]<0){
+                static std::once_flag warned;
+                int err=errno;
+                std::call_once(warned,[err](){
+                    logger.Log(logWarning,std::string("hardware counters unavailable (perf_event_open: ")+strerror(err)+"); timing phases only",true);});
+                for(int o=0;o<c;++o){close(perfFd_[o]);}
+                perfState_=-1;
+                return false;}
+            }//c
+        ioctl(perfFd_[0],PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP);
+        perfState_=1;
+        }
+    uint64_t buffer[1+numHardwareCounters];//{number of counters, values...}
+    if(read(perfFd_[0],buffer,sizeof(buffer))!=(ssize_t)sizeof(buffer)) return false;
+    for(int c=0;c<numHardwareCounters;++c){values[c]=buffer[1+c];}
+    return true;
+#else
+    return false;
+#endif
+    }//ReadHardwareCounters
+
+PhaseProfile::~PhaseProfile(void){
+#ifdef __linux__
+    if(perfState_==1){
+        for(int c=0;c<numHardwareCounters;++c){close(perfFd_[c]);}}
+#endif
+    if(foldOnExit_){
+        std::lock_guard<std::mutex> lock(phaseProfileLock);
+        phaseProfileTotal.Add(*this);}
+    }
+
+PhaseProfile CollectPhaseProfile(void){
+    //call from main() between Popts, when no worker threads are running
+    std::lock_guard<std::mutex> lock(phaseProfileLock);
+    PhaseProfile pp(phaseProfileTotal);
+    pp.Add(threadPhaseProfile);
+    phaseProfileTotal.Reset(); threadPhaseProfile.Reset();
+    return pp;}
+
+class PhaseScope{//profiles a phase for the lifetime of the object, for functions with several returns
+    public:
+        profiledPhase phase_;
+        PhaseScope(profiledPhase phase):phase_(phase){threadPhaseProfile.Begin(phase_);}
+        ~PhaseScope(void){threadPhaseProfile.End(phase_);}
+    };
+
+
+
+//optional Chrome/Perfetto trace of the thread batches (--trace=FILE; open the file in chrome://tracing or ui.perfetto.dev).
+//each worker in a batch appears as "worker t" (t = its slot in the batch), the main thread as "main";
+//spans cover each worker's task and the main thread's wait on join, so idle tails show up as gaps.
+//spans are buffered per thread and handed to traceRecorder when the thread exits or its buffer fills; the recorder
+//writes them out once it holds bufferedEvents_ of them, and after each Popt, so memory stays bounded on long Popts
+class TraceEvent{
+    public:
+        std::string name_;
+        int tid_;
+        long double start_, duration_;//microseconds since the recorder was opened
+        int threads_;//batch size, for join barriers; -1 if not applicable
+        
+    public:
+        TraceEvent(void):tid_(0),start_(zero),duration_(zero),threads_(-1){}
+        TraceEvent(std::string name, int tid, long double start, long double duration, int threads):
+                name_(name),tid_(tid),start_(start),duration_(duration),threads_(threads){}
+        
+        void PrintJSON(std::ostream& out){
+            out<<"{\"name\":\""<<name_<<"\",\"ph\":\"X\",\"pid\":1,\"tid\":"<<tid_;
+            out<<std::fixed; out.precision(3);
+            out<<",\"ts\":"<<start_<<",\"dur\":"<<duration_;
+            out.unsetf(std::ios_base::floatfield); out.precision(6);
+            if(threads_>=0){
+                out<<",\"args\":{\"threads\":"<<threads_<<"}";}
+            out<<"}";}
+    };//class TraceEvent
+
+
+class TraceRecorder{
+    public:
+        static const unsigned long bufferedEvents_=4096;
+        bool enabled_;
+        std::fstream file_;
+        std::chrono::steady_clock::time_point origin_;
+        std::mutex lock_;
+        std::vector<TraceEvent> events_;//handed over by the threads, not yet written
+        
+    public:
+        TraceRecorder(void):enabled_(false){}
+        ~TraceRecorder(void){}
+        
+    public:
+        void Open(std::string fileName){
+            file_.open(fileName.c_str(),std::fstream::out);//overwrites
+            origin_=std::chrono::steady_clock::now();
+            enabled_=true;
+            file_<<"["<<std::endl;//JSON array format; the viewers don't need the closing bracket if a run is killed
+            file_<<"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}";
+            for(int t=1;t<=16;++t){
+                file_<<","<<std::endl<<"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"<<t;
+                file_<<",\"args\":{\"name\":\"worker "<<t<<"\"}}";}
+            }
+        
+        long double Now(void){
+            return std::chrono::duration<long double,std::micro>(std::chrono::steady_clock::now()-origin_).count();}
+        
+        void Add(std::vector<TraceEvent>& events){
+            std::lock_guard<std::mutex> lock(lock_);
+            events_.insert(events_.end(),events.begin(),events.end());
+            events.clear();
+            if(events_.size()>=bufferedEvents_){
+                Write();}
+            }
+        
+        void Write(void){//caller holds lock_
+            for(unsigned long e=0;e<events_.size();++e){
+                file_<<","<<std::endl;
+                events_[e].PrintJSON(file_);}
+            file_.flush();
+            events_.clear();}
+        
+        void Flush(std::vector<TraceEvent>& callerEvents){//call from main() between Popts, with its own buffer
+            if(!enabled_) return;
+            std::lock_guard<std::mutex> lock(lock_);
+            events_.insert(events_.end(),callerEvents.begin(),callerEvents.end());
+            callerEvents.clear();
+            Write();}
+        
+        void Close(std::vector<TraceEvent>& callerEvents){
+            if(!enabled_) return;
+            Flush(callerEvents);
+            file_<<std::endl<<"]"<<std::endl;
+            file_.close();
+            enabled_=false;}
+    };//class TraceRecorder
+
+TraceRecorder traceRecorder;//opened in main() if --trace is given
+
+
+class TraceBuffer{//one per thread
+    public:
+        std::vector<TraceEvent> events_;
+        ~TraceBuffer(void){
+            if(events_.size()>0){traceRecorder.Add(events_);}}
+    };
+thread_local TraceBuffer threadTraceBuffer;
+
+
+class TraceSpan{//records a span from construction to End() (or destruction) when tracing is on
+    public:
+        const char* name_;
+        int tid_, threads_;
+        long double start_;
+        bool open_;
+        
+    public:
+        TraceSpan(int tid, const char* name, int threads=-1):name_(name),tid_(tid),threads_(threads),start_(zero),
+                open_(traceRecorder.enabled_){
+            if(open_){start_=traceRecorder.Now();}}
+        
+        ~TraceSpan(void){End();}
+        
+        void End(void){
+            if(!open_) return;
+            open_=false;
+            threadTraceBuffer.events_.push_back(TraceEvent(name_,tid_,start_,traceRecorder.Now()-start_,threads_));
+            if(threadTraceBuffer.events_.size()>=TraceRecorder::bufferedEvents_){//e.g. main()'s join barriers
+                traceRecorder.Add(threadTraceBuffer.events_);}
+            }
+    };//class TraceSpan
+
+
+template <class F, class... Args> std::thread TracedThread(int slot, const char* name, F f, Args... args){
+    //starts f(args...) in a new thread, recorded as a span on worker row 'slot' when tracing is on
+    return std::thread([=](){
+        TraceSpan span(slot,name);
+        f(args...);});
+    }
+
+
 template <class T> void indicesAtMax(T *val[], int items, T* max, int* x, int& numMaxima){
     numMaxima=1;
     max=val[0]; x[0]=0;
@@ -759,6 +1517,89 @@ template <class T> inline int HammingDistance(T m, T n) {
 enum typeOfModelToRun {dosageOnly=0,tfProductOnly=1,cisOnly=2,tfOnly=3,allSites=4};
 
 
+class GenotypeKey{
+    //a whole genotype packed into one 64-bit word: six bitstringLen-bit fields in the order gtypeString() prints them
+    //(TF dosage 0, TF product 0, TF dosage 1, TF product 1, cis 0, cis 1; the first in the highest bits, so keys
+    //sort like the strings do), with bitstringLen itself in the top 4 bits. only fits bitstringLen<=10,
+    //which covers every run that can finish; for longer bitstrings packed() is false and callers keep the string
+    public:
+    uint64_t key_;
+    static const int maxBitstringLen_=10;
+    static const uint64_t unpacked_=~uint64_t(0);
+
+    public:
+    GenotypeKey(void):key_(unpacked_){}
+    GenotypeKey(int bitstringLen, uint64_t dosage0, uint64_t product0, uint64_t dosage1, uint64_t product1,
+                uint64_t cis0, uint64_t cis1):key_(unpacked_){
+        if(bitstringLen<1 || bitstringLen>maxBitstringLen_) return;
+        uint64_t mask=(uint64_t(1)<<bitstringLen)-1;
+        uint64_t fields[6]={dosage0,product0,dosage1,product1,cis0,cis1};
+        key_=0;
+        for(int f=0;f<6;++f){
+            key_=(key_<<bitstringLen) | (fields[f] & mask);}
+        key_ |= uint64_t(bitstringLen)<<60;}
+    GenotypeKey(const GenotypeKey& gk):key_(gk.key_){}
+    ~GenotypeKey(void){}
+    GenotypeKey& operator=(const GenotypeKey& gk){
+        key_=gk.key_;
+        return *this;}
+
+    public:
+    bool packed(void) const{return key_!=unpacked_;}
+    int bitstringLen(void) const{return packed() ? int(key_>>60) : 0;}
+
+    uint64_t field(int f) const{//0..5, in gtypeString() order
+        int len=bitstringLen();
+        return (key_>>((5-f)*len)) & ((uint64_t(1)<<len)-1);}
+
+    uint64_t Hash(void) const{//splitmix64 finalizer
+        uint64_t h=key_+0x9e3779b97f4a7c15ULL;
+        h=(h^(h>>30))*0xbf58476d1ce4e5b9ULL;
+        h=(h^(h>>27))*0x94d049bb133111ebULL;
+        return h^(h>>31);}
+
+    static void CanonicalOrder(uint64_t fields[6]){//fields in gtypeString() order, for bitstrings too long to pack
+        //allele order carries no information: puts the smaller TF allele (dosage.product) and the smaller cis allele first
+        if(fields[2]<fields[0] || (fields[2]==fields[0] && fields[3]<fields[1])){
+            std::swap(fields[0],fields[2]); std::swap(fields[1],fields[3]);}
+        if(fields[5]<fields[4]){std::swap(fields[4],fields[5]);}
+        }
+
+    GenotypeKey Canonical(void) const{
+        if(!packed()) return *this;
+        uint64_t f[6];
+        for(int i=0;i<6;++i){f[i]=field(i);}
+        CanonicalOrder(f);
+        return GenotypeKey(bitstringLen(),f[0],f[1],f[2],f[3],f[4],f[5]);}
+
+    static unsigned long StringLength(int bitstringLen){//String().size(): the 6 fields plus "{{", the separators & "}}"
+        return 6*(unsigned long)bitstringLen+17;}
+
+    std::string String(void) const{//same format as SimplestRegPathIndividual::gtypeString()
+        if(!packed()) return "";
+        const char* separators[6]={".", " || ", ".", "},{", " || ", "}}"};
+        int len=bitstringLen();
+        std::string gstr="{{";
+        for(int f=0;f<6;++f){
+            uint64_t val=field(f);
+            for(int b=len-1;b>=0;--b){
+                gstr+= ((val>>b)&1) ? '1' : '0';}
+            gstr+=separators[f];}
+        return gstr;}
+
+    friend bool operator==(const GenotypeKey& gk1, const GenotypeKey& gk2){return gk1.key_==gk2.key_;}
+    friend bool operator!=(const GenotypeKey& gk1, const GenotypeKey& gk2){return gk1.key_!=gk2.key_;}
+    friend bool operator<(const GenotypeKey& gk1, const GenotypeKey& gk2){return gk1.key_<gk2.key_;}
+    };//GenotypeKey
+
+class GenotypeKeyHash{//for unordered containers
+    public:
+    size_t operator()(const GenotypeKey& gk) const{return (size_t)gk.Hash();}
+    };//GenotypeKeyHash
+
+
+
+
 class genotypeSettings{
     public:
     uint64_t dosageVal0_,dosageVal1_,tfVal0_,tfVal1_,cisVal0_,cisVal1_;
@@ -779,6 +1620,9 @@ class genotypeSettings{
         tfVal0_=gs.tfVal0_; tfVal1_=gs.tfVal1_;
         cisVal0_=gs.cisVal0_; cisVal1_=gs.cisVal1_;
         return *this;}
+    
+    GenotypeKey key(int bitstringLen){//both alleles of the reference genotype
+        return GenotypeKey(bitstringLen,dosageVal0_,tfVal0_,dosageVal1_,tfVal1_,cisVal0_,cisVal1_);}
         
     };//genotypeSettings
 
@@ -830,6 +1674,373 @@ class simulationSettings{
 
 
 
+uint64_t Fnv1a64(const char* bytes, uint64_t n){
+    uint64_t h=0xcbf29ce484222325ULL;
+    for(uint64_t i=0;i<n;++i){
+        h ^= (unsigned char)bytes[i];
+        h *= 0x100000001b3ULL;}
+    return h;}
+
+
+long double UnscaledExpression(int bitstringLen, int mismatchDosage0, int mismatchDosage1,
+                               int mismatchTF0cis0, int mismatchTF0cis1, int mismatchTF1cis0, int mismatchTF1cis1,
+                               long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+    //expression before scaling by min & max expression; depends on the genotype only through its six mismatch counts
+    long double mDosage0=(long double)mismatchDosage0/(long double)bitstringLen;
+    long double mDosage1=(long double)mismatchDosage1/(long double)bitstringLen;
+    long double mTF0cis0=(long double)mismatchTF0cis0/(long double)bitstringLen;
+    long double mTF0cis1=(long double)mismatchTF0cis1/(long double)bitstringLen;
+    long double mTF1cis0=(long double)mismatchTF1cis0/(long double)bitstringLen;
+    long double mTF1cis1=(long double)mismatchTF1cis1/(long double)bitstringLen;
+    long double alphaDose01 = one+NtfsatPerAllele*exp(mDosage0*deltaG1dosage);
+    long double alphaDose10 = one+NtfsatPerAllele*exp(mDosage1*deltaG1dosage);
+    long double thetaDosage0 = NtfsatPerAllele/(NtfsatPerAllele + alphaDose10*exp(-mDosage0*deltaG1dosage));
+    long double thetaDosage1 = NtfsatPerAllele/(NtfsatPerAllele + alphaDose01*exp(-mDosage1*deltaG1dosage));
+    long double Ntf0=thetaDosage0*NtfsatPerAllele;
+    long double Ntf1=thetaDosage1*NtfsatPerAllele;
+    long double alpha00 = one+Ntf0*exp(mTF0cis0*deltaG1);
+    long double alpha10 = one+Ntf1*exp(mTF1cis0*deltaG1);
+    long double alpha01 = one+Ntf0*exp(mTF0cis1*deltaG1);
+    long double alpha11 = one+Ntf1*exp(mTF1cis1*deltaG1);
+    long double theta00 = Ntf0/(Ntf0 + alpha10*exp(-mTF0cis0*deltaG1));
+    long double theta10 = Ntf1/(Ntf1 + alpha00*exp(-mTF1cis0*deltaG1));
+    long double theta01 = Ntf0/(Ntf0 + alpha11*exp(-mTF0cis1*deltaG1));
+    long double theta11 = Ntf1/(Ntf1 + alpha01*exp(-mTF1cis1*deltaG1));
+    return (theta00+theta10+theta01+theta11)/two;
+    }//UnscaledExpression
+
+
+class PhenotypeTable{
+    //UnscaledExpression() for every combination of the six mismatch counts (0..bitstringLen each), for one set of
+    //(bitstringLen, NtfsatPerAllele, deltaG1dosage, deltaG1), so phenotypes are a lookup instead of a dozen exp()s.
+    //with a cache directory the table is shared through a file that's mmap'd read-only, so every process on a node
+    //uses the same physical pages. file layout: "FOPHTAB1", uint32 version, uint32 sizeof(long double),
+    //int32 bitstringLen, 4 spare bytes, uint64 entries, the three parameters, uint64 checksum of the values,
+    //uint64 checksum of everything before it, padding to byte 128, then the values.
+    //a file whose header or values don't check out is rebuilt
+    public:
+    int bitstringLen_;
+    long double NtfsatPerAllele_,deltaG1dosage_,deltaG1_;
+    uint64_t entries_;
+    const long double* values_;//NULL until built or loaded
+    std::vector<long double> owned_;
+    void* mapped_;
+    size_t mappedBytes_;
+    static const uint32_t version_=1;
+    static const uint64_t headerBytes_=128;
+    static const size_t keyBytesPerParameter_=(sizeof(long double)<10) ? sizeof(long double) : 10;//x87 padding bytes are undefined
+    
+    public:
+    PhenotypeTable(void):bitstringLen_(0),NtfsatPerAllele_(zero),deltaG1dosage_(zero),deltaG1_(zero),entries_(0),
+                        values_(NULL),mapped_(NULL),mappedBytes_(0){}
+    ~PhenotypeTable(void){Release();}
+    
+    public:
+    bool Matches(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1) const{
+        return values_!=NULL && bitstringLen==bitstringLen_ && NtfsatPerAllele==NtfsatPerAllele_
+                && deltaG1dosage==deltaG1dosage_ && deltaG1==deltaG1_;}
+    
+    bool Lookup(const int mismatches[6], long double& unscaledExpression) const{//false if a count is out of range
+        uint64_t index=0;
+        for(int k=0;k<6;++k){
+            if(mismatches[k]<0 || mismatches[k]>bitstringLen_) return false;
+            index=index*(bitstringLen_+1)+mismatches[k];}
+        unscaledExpression=values_[index];
+        return true;}
+    
+    void Build(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+        Release();
+        SetKey(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        owned_.resize(entries_);
+        //same arithmetic as UnscaledExpression(), factored: for given dosage mismatches, theta00 & theta10 depend only
+        //on the TF-cis0 mismatches, and theta01 & theta11 are the same functions of the TF-cis1 mismatches,
+        //so the exp()s are done once per (dosage0, dosage1, TF0-cis, TF1-cis) instead of once per table entry
+        int n=bitstringLen+1;
+        std::vector<long double> thetaTF0(n*n), thetaTF1(n*n);//[TF0-cis mismatches][TF1-cis mismatches]
+        uint64_t i=0;
+        for(int d0=0;d0<n;++d0){
+            for(int d1=0;d1<n;++d1){
+                long double mDosage0=(long double)d0/(long double)bitstringLen;
+                long double mDosage1=(long double)d1/(long double)bitstringLen;
+                long double alphaDose01 = one+NtfsatPerAllele*exp(mDosage0*deltaG1dosage);
+                long double alphaDose10 = one+NtfsatPerAllele*exp(mDosage1*deltaG1dosage);
+                long double thetaDosage0 = NtfsatPerAllele/(NtfsatPerAllele + alphaDose10*exp(-mDosage0*deltaG1dosage));
+                long double thetaDosage1 = NtfsatPerAllele/(NtfsatPerAllele + alphaDose01*exp(-mDosage1*deltaG1dosage));
+                long double Ntf0=thetaDosage0*NtfsatPerAllele;
+                long double Ntf1=thetaDosage1*NtfsatPerAllele;
+                for(int a=0;a<n;++a){
+                    for(int b=0;b<n;++b){
+                        long double mTF0cis=(long double)a/(long double)bitstringLen;
+                        long double mTF1cis=(long double)b/(long double)bitstringLen;
+                        long double alphaTF0 = one+Ntf0*exp(mTF0cis*deltaG1);
+                        long double alphaTF1 = one+Ntf1*exp(mTF1cis*deltaG1);
+                        thetaTF0[a*n+b] = Ntf0/(Ntf0 + alphaTF1*exp(-mTF0cis*deltaG1));
+                        thetaTF1[a*n+b] = Ntf1/(Ntf1 + alphaTF0*exp(-mTF1cis*deltaG1));}
+                    }
+                for(int m00=0;m00<n;++m00){//index order: TF0-cis0, TF0-cis1, TF1-cis0, TF1-cis1
+                    for(int m01=0;m01<n;++m01){
+                        for(int m10=0;m10<n;++m10){
+                            for(int m11=0;m11<n;++m11){
+                                owned_[i++]=(thetaTF0[m00*n+m10]+thetaTF1[m00*n+m10]+thetaTF0[m01*n+m11]+thetaTF1[m01*n+m11])/two;}
+                            }
+                        }
+                    }
+                }//d1
+            }//d0
+        values_=owned_.data();}
+    
+    int LoadOrBuild(std::string cacheDir, int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+        //maps the cached table, building & publishing it first if need be; -1 if the cache can't be used,
+        //in which case the table is built in memory
+#if !(defined(__unix__) || defined(__APPLE__))
+        Build(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        return -1;
+#else
+        std::string fileName=CacheFileName(cacheDir,bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        if(Map(fileName,bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1)==0) return 0;
+        Build(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        std::string tmpName=fileName+".tmp"+std::to_string((long long)getpid());
+        std::string header=Header();
+        std::ofstream out(tmpName.c_str(),std::ios::binary|std::ios::trunc);
+        if(!out.is_open()) return -1;
+        out.write(header.data(),header.size());
+        out.write((const char*)owned_.data(),entries_*sizeof(long double));
+        out.close();
+        if(out.fail() || std::rename(tmpName.c_str(),fileName.c_str())!=0){//other processes only ever see a whole file
+            std::remove(tmpName.c_str());
+            return -1;}
+        Map(fileName,bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);//keeps the in-memory copy if this fails
+        return 0;
+#endif
+        }
+    
+    void Release(void){
+#if defined(__unix__) || defined(__APPLE__)
+        if(mapped_!=NULL){munmap(mapped_,mappedBytes_);}
+#endif
+        mapped_=NULL; mappedBytes_=0;
+        owned_.clear(); owned_.shrink_to_fit();
+        values_=NULL;}
+    
+    bool isMapped(void){return mapped_!=NULL;}
+    
+    public:
+    void SetKey(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+        bitstringLen_=bitstringLen; NtfsatPerAllele_=NtfsatPerAllele; deltaG1dosage_=deltaG1dosage; deltaG1_=deltaG1;
+        entries_=1;
+        for(int k=0;k<6;++k){entries_*=(uint64_t)(bitstringLen+1);}
+        }
+    
+    static std::string KeyBytes(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+        std::string key((const char*)&bitstringLen,sizeof(int));
+        long double params[3]={NtfsatPerAllele,deltaG1dosage,deltaG1};
+        for(int k=0;k<3;++k){
+            key.append((const char*)&params[k],keyBytesPerParameter_);}
+        return key;}
+    
+    std::string CacheFileName(std::string cacheDir, int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+        std::string key=KeyBytes(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        char hex[17];
+        std::snprintf(hex,sizeof(hex),"%016llx",(unsigned long long)Fnv1a64(key.data(),key.size()));
+        std::stringstream name;
+        name<<cacheDir<<"/phenotypeTable_b"<<bitstringLen<<"_Ntf"<<NtfsatPerAllele<<"_"<<hex<<".bin";
+        return name.str();}
+    
+    std::string Header(void){
+        std::string header(headerBytes_,'\0');
+        uint32_t version=version_, ldBytes=sizeof(long double);
+        std::memcpy(&header[0],"FOPHTAB1",8);
+        std::memcpy(&header[8],&version,4); std::memcpy(&header[12],&ldBytes,4);
+        std::memcpy(&header[16],&bitstringLen_,4);
+        std::memcpy(&header[24],&entries_,8);
+        std::string key=KeyBytes(bitstringLen_,NtfsatPerAllele_,deltaG1dosage_,deltaG1_);
+        std::memcpy(&header[32],key.data()+sizeof(int),3*keyBytesPerParameter_);
+        uint64_t valuesChecksum=ValuesChecksum(values_,entries_);
+        std::memcpy(&header[64],&valuesChecksum,8);
+        uint64_t headerChecksum=Fnv1a64(header.data(),72);
+        std::memcpy(&header[72],&headerChecksum,8);
+        return header;}
+    
+    static uint64_t ValuesChecksum(const long double* values, uint64_t entries){
+        uint64_t h=0;
+        for(uint64_t i=0;i<entries;++i){
+            h=h*0x100000001b3ULL ^ Fnv1a64((const char*)&values[i],keyBytesPerParameter_);}
+        return h;}
+    
+    int Map(std::string fileName, int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1){
+        //-1 if the file is missing or doesn't validate against these parameters
+#if defined(__unix__) || defined(__APPLE__)
+        int fd=open(fileName.c_str(),O_RDONLY);
+        if(fd==-1) return -1;
+        struct stat st;
+        PhenotypeTable expected;
+        expected.SetKey(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        size_t bytes=headerBytes_+expected.entries_*sizeof(long double);
+        if(fstat(fd,&st)!=0 || (size_t)st.st_size!=bytes){close(fd); return -1;}
+        void* mapped=mmap(NULL,bytes,PROT_READ,MAP_SHARED,fd,0);
+        close(fd);
+        if(mapped==MAP_FAILED) return -1;
+        const char* header=(const char*)mapped;
+        const long double* values=(const long double*)(header+headerBytes_);
+        expected.values_=values;
+        std::string expectedHeader=expected.Header();
+        expected.values_=NULL;
+        uint64_t headerChecksum;
+        std::memcpy(&headerChecksum,header+72,8);
+        if(Fnv1a64(header,72)!=headerChecksum || std::memcmp(header,expectedHeader.data(),80)!=0){
+            munmap(mapped,bytes);
+            return -1;}
+        Release();
+        SetKey(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        mapped_=mapped; mappedBytes_=bytes;
+        values_=values;
+        return 0;
+#else
+        return -1;
+#endif
+        }
+    };//class PhenotypeTable
+
+PhenotypeTable phenotypeTable;//set up in main(); used by CalculatePhenotype() when its parameters match
+
+
+
+class PhenotypeIndex{
+    //every mismatch configuration (dosage0, dosage1, TF0-cis0, TF0-cis1, TF1-cis0, TF1-cis1), numbered as in
+    //PhenotypeTable, sorted by scaled phenotype, so Prepare() can walk out from Popt in order of distance.
+    //fitness is exp(-(phenotype-Popt)^2/omega^2), and wBar at equilibrium is at most the fitness of the fittest of the
+    //9 genotypes a reference g'type makes; so once the sweep has a maximum wBar, a reference none of whose 9
+    //genotypes is close enough to Popt to have fitness wBar can't equal it, and neither can any reference whose TF
+    //dosage pair has no configuration that close. skipping those leaves the solutions unchanged.
+    //wBar is rounded to decimalDigitsToRound places before it's compared, so the bound is rounded the same way;
+    //phenotypes are kept as doubles, and margin_ more than covers their rounding
+    public:
+    bool enabled_;
+    int bitstringLen_;
+    std::vector<double> phenotypeByConfig_, sortedPhenotypes_;
+    std::vector<uint32_t> sortedConfigs_;
+    long double Popt_;
+    std::vector<double> nearestByDosage_;//[dosage0 mismatches][dosage1 mismatches]: min |phenotype - Popt_|
+    static const double margin_;
+    
+    public:
+    PhenotypeIndex(void):enabled_(false),bitstringLen_(0),Popt_(-one){}
+    ~PhenotypeIndex(void){}
+    
+    public:
+    void Build(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1,
+                long double minExpression, long double maxExpression){
+        bitstringLen_=bitstringLen;
+        int n=bitstringLen+1;
+        uint64_t entries=(uint64_t)n*n*n*n*n*n;
+        bool tabled=phenotypeTable.Matches(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);
+        phenotypeByConfig_.resize(entries);
+        int m[6];
+        for(uint64_t c=0;c<entries;++c){
+            uint64_t rest=c;
+            for(int k=5;k>=0;--k){m[k]=rest%n; rest/=n;}
+            long double thetaUnscaled;
+            if(!(tabled && phenotypeTable.Lookup(m,thetaUnscaled))){
+                thetaUnscaled=UnscaledExpression(bitstringLen,m[0],m[1],m[2],m[3],m[4],m[5],NtfsatPerAllele,deltaG1dosage,deltaG1);}
+            phenotypeByConfig_[c]=(double)MAX((thetaUnscaled-minExpression)/(maxExpression-minExpression),zero);//as CalculatePhenotype()
+            }
+        sortedConfigs_.resize(entries);
+        for(uint64_t c=0;c<entries;++c){sortedConfigs_[c]=(uint32_t)c;}
+        std::stable_sort(sortedConfigs_.begin(),sortedConfigs_.end(),
+            [this](uint32_t a, uint32_t b){return phenotypeByConfig_[a]<phenotypeByConfig_[b];});
+        sortedPhenotypes_.resize(entries);
+        for(uint64_t i=0;i<entries;++i){sortedPhenotypes_[i]=phenotypeByConfig_[sortedConfigs_[i]];}
+        Popt_=-one;
+        }//Build
+    
+    long double FitnessAt(long double distance, long double omega){
+        return exp(-distance*distance/(omega*omega));}
+    
+    bool CanReach(double nearest, long double omega, long double wBar){//as OneReferenceGtype compares wBar
+        return ROUND(FitnessAt(nearest,omega)+margin_,decimalDigitsToRound)>=wBar;}
+    
+    void Prepare(long double Popt){
+        //nearest configuration to Popt for each pair of dosage mismatches, walking out from Popt through the index
+        if(Popt==Popt_ || sortedConfigs_.size()==0) return;
+        int n=bitstringLen_+1, unseen=n*n;
+        uint64_t n4=(uint64_t)n*n*n*n;
+        nearestByDosage_.assign(n*n,-1.0);
+        int64_t above=std::lower_bound(sortedPhenotypes_.begin(),sortedPhenotypes_.end(),(double)Popt)-sortedPhenotypes_.begin();
+        int64_t below=above-1, entries=(int64_t)sortedPhenotypes_.size();
+        while(unseen>0 && (below>=0 || above<entries)){
+            int64_t i;
+            if(below<0 || (above<entries && sortedPhenotypes_[above]-(double)Popt<(double)Popt-sortedPhenotypes_[below])){
+                    i=above++;}
+                else{
+                    i=below--;}
+            uint64_t dosages=sortedConfigs_[i]/n4;//dosage0*n + dosage1
+            if(nearestByDosage_[dosages]<0.0){
+                nearestByDosage_[dosages]=std::fabs(sortedPhenotypes_[i]-(double)Popt);
+                --unseen;}
+            }
+        Popt_=Popt;}
+    
+    bool DosagesCanReach(uint64_t dosageVal0, uint64_t dosageVal1, long double Popt, long double omega, long double wBar){
+        //can any reference with these TF dosage alleles (whatever the products & cis) have wBar>=wBar?
+        if(wBar<=zero || Popt!=Popt_) return true;
+        int n=bitstringLen_+1;
+        uint64_t tacitTF=(uint64_t) 0;
+        int k0=HammingDistance(tacitTF,dosageVal0), k1=HammingDistance(tacitTF,dosageVal1);
+        double nearest=MIN(MIN(nearestByDosage_[k0*n+k0],nearestByDosage_[k0*n+k1]),nearestByDosage_[k1*n+k1]);//AA, Aa, aa
+        return CanReach(nearest,omega,wBar);}
+    
+    bool ReferenceCanReach(const genotypeSettings& g, long double Popt, long double omega, long double wBar){
+        //can this reference have wBar>=wBar? checks the 9 genotypes it makes
+        if(wBar<=zero || phenotypeByConfig_.size()==0) return true;
+        int n=bitstringLen_+1;
+        uint64_t tacitTF=(uint64_t) 0;
+        uint64_t dosage[2]={g.dosageVal0_,g.dosageVal1_}, product[2]={g.tfVal0_,g.tfVal1_}, cis[2]={g.cisVal0_,g.cisVal1_};
+        double nearest=two;
+        for(int x=0;x<2;++x){for(int y=x;y<2;++y){//TF alleles AA, Aa, aa
+            for(int u=0;u<2;++u){for(int v=u;v<2;++v){//cis alleles BB, Bb, bb
+                uint64_t c=HammingDistance(tacitTF,dosage[x]);
+                c=c*n+HammingDistance(tacitTF,dosage[y]);
+                c=c*n+HammingDistance(product[x],cis[u]);
+                c=c*n+HammingDistance(product[x],cis[v]);
+                c=c*n+HammingDistance(product[y],cis[u]);
+                c=c*n+HammingDistance(product[y],cis[v]);
+                nearest=MIN(nearest,std::fabs(phenotypeByConfig_[c]-(double)Popt));}}
+                }}
+        return CanReach(nearest,omega,wBar);}
+    };//class PhenotypeIndex
+const double PhenotypeIndex::margin_=1e-12;
+PhenotypeIndex phenotypeIndex;//built in main() with the phenotype table, unless --no-phenotype-prune
+
+
+class NtfsatPreset{//the binding energies that go with each standard Ntfsat (double literals, as they've always been)
+    public:
+    int Ntfsat_;
+    long double deltaG1dosage_, deltaG1_;
+    };//NtfsatPreset
+
+constexpr NtfsatPreset ntfsatPresets[5]={
+    {10, -3.89182, -3.58352},
+    {30, -5.66643, -5.54518},
+    {100, -7.90249, -7.86365},
+    {300, -10.0478, -10.0346},
+    {1000, -12.4372, -12.4332}};
+
+void NtfsatDeltaGs(long double NtfsatPerAllele, long double& deltaG1dosage, long double& deltaG1){
+    //the presets are deltaG1dosage = -2 ln(Ntfsat/2 + 2) and deltaG1 = -2 ln(Ntfsat/2 + 1), to the six figures they
+    //were written with; a preset Ntfsat keeps its rounded values so old runs come out the same, anything else
+    //(including non-integer Ntfsat) gets the formula
+    for(int k=0;k<5;++k){
+        if((long double)ntfsatPresets[k].Ntfsat_==NtfsatPerAllele){
+            deltaG1dosage=ntfsatPresets[k].deltaG1dosage_;
+            deltaG1=ntfsatPresets[k].deltaG1_;
+            return;}}
+    deltaG1dosage=-two*log(NtfsatPerAllele/two+two);
+    deltaG1=-two*log(NtfsatPerAllele/two+one);
+    }//NtfsatDeltaGs
+
+
+
+
 class SimplestRegPathIndividual;
 class SimplestRegPathIndividual{
   public:
@@ -919,6 +2130,9 @@ std::string binaryFromUnsignedLongLong(unsigned long long val, bool fullString,
 		return gstr;
 		}//gtypeString
 
+	GenotypeKey gtypeKey(int bitstringLen){//packed form of gtypeString(); unpacked (empty) for bitstringLen>10
+		return GenotypeKey(bitstringLen,TFdosage_[0],TFproduct_[0],TFdosage_[1],TFproduct_[1],cis_[0],cis_[1]);}
+
 
 	std::string mismatchStringMathematicaFormat(void){
         if(mismatchGtype_[0]=='{'){//it's been calculated
@@ -1014,39 +2228,24 @@ std::string binaryFromUnsignedLongLong(unsigned long long val, bool fullString,
 
 	long double CalculatePhenotype(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1, long double minExpression, long double maxExpression){
 		if(phenotypeCalculated_){return phenotype_;}
-		long double mDosage0,mDosage1,mTF0cis0,mTF0cis1,mTF1cis0,mTF1cis1;
+		int m[6];//dosage 0, dosage 1, TF0-cis0, TF0-cis1, TF1-cis0, TF1-cis1
 		uint64_t tacitTF=(uint64_t) 0;
 		if(useMismatchesToCalculatePhenotype_){
-				mDosage0=(long double)mTFdosage_[0]/(long double)bitstringLen;
-				mDosage1=(long double)mTFdosage_[1]/(long double)bitstringLen;
-				mTF0cis0=(long double)mTF01cis01_[0][0]/(long double)bitstringLen;
-				mTF0cis1=(long double)mTF01cis01_[0][1]/(long double)bitstringLen;
-				mTF1cis0=(long double)mTF01cis01_[1][0]/(long double)bitstringLen;
-				mTF1cis1=(long double)mTF01cis01_[1][1]/(long double)bitstringLen;
+				m[0]=mTFdosage_[0]; m[1]=mTFdosage_[1];
+				m[2]=mTF01cis01_[0][0]; m[3]=mTF01cis01_[0][1];
+				m[4]=mTF01cis01_[1][0]; m[5]=mTF01cis01_[1][1];
 				}
 			else{
-				mDosage0=(long double)HammingDistance(tacitTF,TFdosage_[0])/(long double)bitstringLen;
-				mDosage1=(long double)HammingDistance(tacitTF,TFdosage_[1])/(long double)bitstringLen;
-				mTF0cis0=(long double)HammingDistance(TFproduct_[0],cis_[0])/(long double)bitstringLen;
-				mTF0cis1=(long double)HammingDistance(TFproduct_[0],cis_[1])/(long double)bitstringLen;
-				mTF1cis0=(long double)HammingDistance(TFproduct_[1],cis_[0])/(long double)bitstringLen;
-				mTF1cis1=(long double)HammingDistance(TFproduct_[1],cis_[1])/(long double)bitstringLen;
+				m[0]=HammingDistance(tacitTF,TFdosage_[0]);
+				m[1]=HammingDistance(tacitTF,TFdosage_[1]);
+				m[2]=HammingDistance(TFproduct_[0],cis_[0]);
+				m[3]=HammingDistance(TFproduct_[0],cis_[1]);
+				m[4]=HammingDistance(TFproduct_[1],cis_[0]);
+				m[5]=HammingDistance(TFproduct_[1],cis_[1]);
 				}
-		long double alphaDose01 = one+NtfsatPerAllele*exp(mDosage0*deltaG1dosage);
-		long double alphaDose10 = one+NtfsatPerAllele*exp(mDosage1*deltaG1dosage);
-		long double thetaDosage0 = NtfsatPerAllele/(NtfsatPerAllele + alphaDose10*exp(-mDosage0*deltaG1dosage));
-		long double thetaDosage1 = NtfsatPerAllele/(NtfsatPerAllele + alphaDose01*exp(-mDosage1*deltaG1dosage));
-		long double Ntf0=thetaDosage0*NtfsatPerAllele;
-		long double Ntf1=thetaDosage1*NtfsatPerAllele;
-		long double alpha00 = one+Ntf0*exp(mTF0cis0*deltaG1);
-		long double alpha10 = one+Ntf1*exp(mTF1cis0*deltaG1);
-		long double alpha01 = one+Ntf0*exp(mTF0cis1*deltaG1);
-		long double alpha11 = one+Ntf1*exp(mTF1cis1*deltaG1);
-		long double theta00 = Ntf0/(Ntf0 + alpha10*exp(-mTF0cis0*deltaG1));
-		long double theta10 = Ntf1/(Ntf1 + alpha00*exp(-mTF1cis0*deltaG1));
-		long double theta01 = Ntf0/(Ntf0 + alpha11*exp(-mTF0cis1*deltaG1));
-		long double theta11 = Ntf1/(Ntf1 + alpha01*exp(-mTF1cis1*deltaG1));
-		long double thetaUnscaled = (theta00+theta10+theta01+theta11)/two;
+		long double thetaUnscaled;
+		if(!(phenotypeTable.Matches(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1) && phenotypeTable.Lookup(m,thetaUnscaled))){
+			thetaUnscaled=UnscaledExpression(bitstringLen,m[0],m[1],m[2],m[3],m[4],m[5],NtfsatPerAllele,deltaG1dosage,deltaG1);}
 		long double scaledExpression = (thetaUnscaled-minExpression)/(maxExpression-minExpression);
 		phenotype_ = MAX(scaledExpression,zero);
 		phenotypeCalculated_=true;
@@ -1292,6 +2491,7 @@ class BitstringGenotypeData{
     long double fitness_;
     bool phenotypeCalculated_;
     bool fitnessCalculated_;
+    GenotypeKey gtypeKey_;//packed bitstringGtype_, when CollectData() could pack it
     
   public:
     BitstringGenotypeData(void){}
@@ -1319,6 +2519,7 @@ class BitstringGenotypeData{
         fitness_=bgd.fitness_;
         phenotypeCalculated_=bgd.phenotypeCalculated_;
         fitnessCalculated_=bgd.fitnessCalculated_;
+        gtypeKey_=bgd.gtypeKey_;
         return *this;}
     
     std::string& genotype(void){return bitstringGtype_;}
@@ -1332,6 +2533,7 @@ class BitstringGenotypeData{
     void CollectData(SimplestRegPathIndividual& indiv, int bitstringlen){
         indiv.SetMismatchesUsingBitstrings();
         bitstringGtype_=indiv.gtypeString(bitstringlen);
+        gtypeKey_=indiv.gtypeKey(bitstringlen);
         mismatchPattern_=indiv.mismatchStringMathematicaFormat();
         trueHetcode_=indiv.hetType(false);
         mismatchHetcode_=indiv.hetType(true);
@@ -1344,7 +2546,7 @@ class BitstringGenotypeData{
         }//CollectData()
     
     void SetBitstring(std::string& bitstringGtype, std::string& hetcode){
-        bitstringGtype_=bitstringGtype; trueHetcode_=hetcode;}
+        bitstringGtype_=bitstringGtype; trueHetcode_=hetcode; gtypeKey_=GenotypeKey();}
     
     void SetFitness(long double& fitness){
         fitness_=fitness; fitnessCalculated_=true;}
@@ -1375,7 +2577,8 @@ class BitstringGenotypeData{
     void Clear(void){
         bitstringGtype_.clear();mismatchPattern_.clear();
         trueHetcode_.clear();mismatchHetcode_.clear();
-        phenotype_=fitness_=zero; phenotypeCalculated_=fitnessCalculated_=false;}
+        phenotype_=fitness_=zero; phenotypeCalculated_=fitnessCalculated_=false;
+        gtypeKey_=GenotypeKey();}
     
     friend int operator==(BitstringGenotypeData& bgd1, BitstringGenotypeData& bgd2);
     friend int operator!=(BitstringGenotypeData& bgd1, BitstringGenotypeData& bgd2);
@@ -1410,7 +2613,8 @@ class FitnessLandscapeParameters{
                      long double wAaBB,long double wAaBb,long double wAabb,
                     long double waaBB,long double waaBb,long double waabb):wBarMax_(wBarMax),pBarAtMax_(pBarAtMax),
     pAABB_(pAABB),pAABb_(pAABb),pAAbb_(pAAbb),pAaBB_(pAaBB),pAaBb_(pAaBb),pAabb_(pAabb),paaBB_(paaBB),paaBb_(paaBb),paabb_(paabb),
-    wAABB_(wAABB),wAABb_(wAABb),wAAbb_(wAAbb),wAaBB_(wAaBB),wAaBb_(wAaBb),wAabb_(wAabb),waaBB_(waaBB),waaBb_(waaBb),waabb_(waabb){}
+    wAABB_(wAABB),wAABb_(wAABb),wAAbb_(wAAbb),wAaBB_(wAaBB),wAaBb_(wAaBb),wAabb_(wAabb),waaBB_(waaBB),waaBb_(waaBb),waabb_(waabb){
+        wBarMaxCalculated_=pBarAtMaxCalculated_=true;}
         
     FitnessLandscapeParameters(const FitnessLandscapeParameters& flp){
         operator=(flp);}
@@ -1455,6 +2659,15 @@ class FitnessLandscapeParameters{
     void SetWbarMax(long double wBarMax){
         wBarMax_=wBarMax;wBarMaxCalculated_=true;}
 
+    uint64_t EqualityHash(void) const{//hash of everything operator== compares, so equal landscapes hash alike
+        std::hash<long double> hashLD;
+        long double parts[18]={wAABB_,wAABb_,wAAbb_,wAaBB_,wAaBb_,wAabb_,waaBB_,waaBb_,waabb_,
+                pAABB_,pAABb_,pAAbb_,pAaBB_,pAaBb_,pAabb_,paaBB_,paaBb_,paabb_};
+        uint64_t h=(uint64_t)wBarMaxCalculated_+2*(uint64_t)pBarAtMaxCalculated_;
+        for(int i=0;i<18;++i){
+            h ^= hashLD(parts[i])+0x9e3779b97f4a7c15ULL+(h<<6)+(h>>2);}
+        return h;}
+
     friend int operator==(const FitnessLandscapeParameters& flp1, const FitnessLandscapeParameters& flp2);
     friend int operator!=(const FitnessLandscapeParameters& flp1, const FitnessLandscapeParameters& flp2);
     };// class FitnessLandscapeParameters
@@ -1501,7 +2714,11 @@ public:
     std::string mismatchHetcode_;
     //use these for checking fitness surfaces in Mathematica
     std::vector<FitnessLandscapeParameters> fitnessLandscapesAndGPmaps_;
-    std::vector<BitstringGenotypeData> referenceGenotypes_;
+    std::unordered_map<uint64_t,std::vector<int> > landscapeIndex_;//EqualityHash() -> indices in fitnessLandscapesAndGPmaps_
+    //reference genotypes are kept packed, 8 bytes each, in the order they're found;
+    //the strings are only used for bitstrings too long for a GenotypeKey
+    std::vector<GenotypeKey> referenceGenotypes_;
+    std::vector<std::string> unpackedReferenceGenotypes_;
     bool headerPrinted_;
     static const long double tol_;
 
@@ -1522,7 +2739,9 @@ public:
         pNeutral_=fd.pNeutral_;
         qNeutral_=fd.qNeutral_;
         fitnessLandscapesAndGPmaps_=fd.fitnessLandscapesAndGPmaps_;
+        landscapeIndex_=fd.landscapeIndex_;
         referenceGenotypes_=fd.referenceGenotypes_;
+        unpackedReferenceGenotypes_=fd.unpackedReferenceGenotypes_;
         headerPrinted_=fd.headerPrinted_;
         }
     ~FitnessMaximumBitstringSolution(void){
@@ -1542,7 +2761,9 @@ public:
         pNeutral_=fd.pNeutral_;
         qNeutral_=fd.qNeutral_;
         fitnessLandscapesAndGPmaps_=fd.fitnessLandscapesAndGPmaps_;
+        landscapeIndex_=fd.landscapeIndex_;
         referenceGenotypes_=fd.referenceGenotypes_;
+        unpackedReferenceGenotypes_=fd.unpackedReferenceGenotypes_;
         headerPrinted_=fd.headerPrinted_;
         return *this;
         }//operator=
@@ -1552,11 +2773,30 @@ public:
     void AppendReferenceGenotype(BitstringGenotypeData& refBGD){
         //doesn't check whether refBGD is equal or equivalent to an already listed genotype
         //i.e., if AaBb is already listed, then whether it refBGD is AaBb, AabB, aABb or aAbB
-        referenceGenotypes_.push_back(refBGD);}
+        if(refBGD.gtypeKey_.packed()){
+                referenceGenotypes_.push_back(refBGD.gtypeKey_);}
+            else{
+                unpackedReferenceGenotypes_.push_back(refBGD.genotype());}
+        }
     
     void AppendReferenceGenotype(FitnessMaximumBitstringSolution& alternateSolution){
-        //use after testing that the alternateSolution is the same as this solution
-        AppendReferenceGenotype(alternateSolution.solution_);}
+        //use after testing that the alternateSolution is the same as this solution;
+        //takes its reference genotypes (not its solution genotype) and any landscapes not already listed
+        referenceGenotypes_.insert(referenceGenotypes_.end(),alternateSolution.referenceGenotypes_.begin(),
+                                   alternateSolution.referenceGenotypes_.end());
+        unpackedReferenceGenotypes_.insert(unpackedReferenceGenotypes_.end(),alternateSolution.unpackedReferenceGenotypes_.begin(),
+                                           alternateSolution.unpackedReferenceGenotypes_.end());
+        for(unsigned long j=0;j<alternateSolution.fitnessLandscapesAndGPmaps_.size();++j){
+            AddFitnessLandscape(alternateSolution.fitnessLandscapesAndGPmaps_[j]);}
+        }
+    
+    unsigned long numReferenceGenotypes(void){
+        return referenceGenotypes_.size()+unpackedReferenceGenotypes_.size();}
+    
+    std::string referenceGenotype(unsigned long i){
+        if(i<referenceGenotypes_.size()) return referenceGenotypes_[i].String();
+        if(i<numReferenceGenotypes()) return unpackedReferenceGenotypes_[i-referenceGenotypes_.size()];
+        return "";}
     
     std::string& hetcode(void){return solution_.hetcode();}
     std::string& mismatchHetcode(void){return solution_.mismatchHetcode();}
@@ -1636,8 +2876,8 @@ public:
         std::cout<<"\tphBar="<<ROUND(phBar_,decimalDigitsToRound)<<std::endl;
         std::cout<<"  solution mismatch pattern="<<solution_.mismatchPattern()<<"\tcode="<<solution_.mismatchHetcode()<<std::endl;
         std::cout<<"   from reference genotypes:"<<std::endl;
-        for(int i=0;i<referenceGenotypes_.size();++i){
-            std::cout<<"    "<<referenceGenotypes_[i].genotype()<<std::endl;}
+        for(unsigned long i=0;i<numReferenceGenotypes();++i){
+            std::cout<<"    "<<referenceGenotype(i)<<std::endl;}
         std::cout<<std::endl;
 //        coutLock.unlock();
         }//reportToScreen
@@ -1650,7 +2890,9 @@ public:
         pNeutral_=qNeutral_=false;
         TFdosageAlleles_.clear();TFprodAlleles_.clear();cisAlleles_.clear();
         fitnessLandscapesAndGPmaps_.clear();
+        landscapeIndex_.clear();
         referenceGenotypes_.clear();
+        unpackedReferenceGenotypes_.clear();
         }//Reset
 
 
@@ -1663,14 +2905,20 @@ public:
                  long double waaBB,long double waaBb,long double waabb){
         FitnessLandscapeParameters flp(wBarMax,pBarAtMax,pAABB,pAABb,pAAbb,pAaBB,pAaBb,pAabb,paaBB,paaBb,paabb,
                                         wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb);
+        AddFitnessLandscape(flp);
+        }//SetFitnessLandscape
+
+     void AddFitnessLandscape(FitnessLandscapeParameters& flp){
+         std::vector<int>& bucket=landscapeIndex_[flp.EqualityHash()];
          bool found=false;
-         for(int f=0;f<fitnessLandscapesAndGPmaps_.size();++f){
-             if(flp==fitnessLandscapesAndGPmaps_[f]){
-                 found=true;}
-             }//f
+         for(unsigned long b=0;b<bucket.size();++b){
+             if(flp==fitnessLandscapesAndGPmaps_[bucket[b]]){
+                 found=true;break;}
+             }//b
          if(!found){
+             bucket.push_back((int)fitnessLandscapesAndGPmaps_.size());
              fitnessLandscapesAndGPmaps_.push_back(flp);}
-        }//SetFitnessLandscape
+        }//AddFitnessLandscape
 
      
     
@@ -1739,7 +2987,7 @@ public:
     FitnessMaximaBitstringSolutions(void){
         wBarMax_=Popt_=omega_= (double)-one;//error code
         headerPrinted_=false;
-        for(int h=0;h<26;++h){
+        for(int h=0;h<27;++h){//codeToInt() gives 0-26
             std::vector<FitnessMaximumBitstringSolution> hetcategory;
             solutionsByHetCode_.push_back(hetcategory);}
     }
@@ -1782,7 +3030,7 @@ public:
 
     unsigned long items(void){
         unsigned long n=0;
-        for(int h=0;h<26;++h){
+        for(unsigned long h=0;h<solutionsByHetCode_.size();++h){
             n += solutionsByHetCode_[h].size();}
         return n;}
 
@@ -1790,7 +3038,7 @@ public:
         return solutionsByHetCode_[hetcode].size();}
 
     
-    void PrintSolutionTable(std::ostream& outfile, double Popt, double omega, int Ntf){
+    void PrintSolutionTable(std::ostream& outfile, double Popt, double omega, double Ntf){
         PrintSolutionTableHeader(outfile);
         PrintSolutionTableData(outfile, Popt, omega, Ntf);
         }//PrintSolutionTable
@@ -1808,48 +3056,78 @@ public:
         }//PrintSolutionTableHeader
     
     
-    void PrintSolutionTableData(std::ostream& outfile, double Popt, double omega, int Ntf){
-        std::string tab("\t");
+    void PrintSolutionTableData(std::ostream& outfile, double Popt, double omega, double Ntf){
+        BufferedTableWriter writer(outfile);
+        StreamSolutionTableData(writer,Popt,omega,Ntf);
+        writer.Flush();
+        }//PrintSolutionTableData
+
+    void StreamSolutionTableData(BufferedTableWriter& writer, double Popt, double omega, double Ntf){
+        char tab='\t';
+        auto optional=[&writer](long double val){//blank for the -one error code
+            if(val!=-one){writer.Number(ROUND(val,decimalDigitsToRound));}};
         for(int h=0;h<solutionsByHetCode_.size();++h){
             std::string c=intToHetcode(h);
             for(int i=0;i<solutionsByHetCode_[h].size();++i){
                 FitnessMaximumBitstringSolution& s=solutionsByHetCode_[h][i];
+                std::string firstRef=s.referenceGenotype(0);
                 for(int j=0;j<s.fitnessLandscapesAndGPmaps_.size();++j){
                     FitnessLandscapeParameters& flp = s.fitnessLandscapesAndGPmaps_[j];
-                    outfile<<Popt<<tab<<omega<<tab<<Ntf<<tab<<ROUND(wBarMax_,decimalDigitsToRound)<<tab<<h<<tab<<c<<tab;
-                    if(!(s.pNeutral())){outfile<<ROUND(s.phat_,decimalDigitsToRound);}
-                    outfile<<tab;
-                    if(!(s.qNeutral())){outfile<<ROUND(s.qhat_,decimalDigitsToRound);}
-                    outfile<<tab;
-                    outfile<<ROUND(s.phBar_,decimalDigitsToRound)<<tab<<s.solutionGenotype();// <<tab<<s.ABgenotype();
-                    outfile<<tab<<s.solutionMismatchPattern()<<tab<<s.referenceGenotypes_.size()<<tab;
-                    outfile<<s.referenceGenotypes_[0].genotype()<<tab;
-                    if(flp.wAABB_!=-one){outfile<<ROUND(flp.wAABB_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.wAABb_!=-one){outfile<<ROUND(flp.wAABb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.wAAbb_!=-one){outfile<<ROUND(flp.wAAbb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.wAaBB_!=-one){outfile<<ROUND(flp.wAaBB_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.wAaBb_!=-one){outfile<<ROUND(flp.wAaBb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.wAabb_!=-one){outfile<<ROUND(flp.wAabb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.waaBB_!=-one){outfile<<ROUND(flp.waaBB_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.waaBb_!=-one){outfile<<ROUND(flp.waaBb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.waabb_!=-one){outfile<<ROUND(flp.waabb_,decimalDigitsToRound);}outfile<<tab;
-
-                    if(flp.pAABB_!=-one){outfile<<ROUND(flp.pAABB_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.pAABb_!=-one){outfile<<ROUND(flp.pAABb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.pAAbb_!=-one){outfile<<ROUND(flp.pAAbb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.pAaBB_!=-one){outfile<<ROUND(flp.pAaBB_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.pAaBb_!=-one){outfile<<ROUND(flp.pAaBb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.pAabb_!=-one){outfile<<ROUND(flp.pAabb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.paaBB_!=-one){outfile<<ROUND(flp.paaBB_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.paaBb_!=-one){outfile<<ROUND(flp.paaBb_,decimalDigitsToRound);}outfile<<tab;
-                    if(flp.paabb_!=-one){outfile<<ROUND(flp.paabb_,decimalDigitsToRound);}outfile<<std::endl;
+                    writer.Number(Popt); writer.Append(tab); writer.Number(omega); writer.Append(tab);
+                    writer.Number(Ntf); writer.Append(tab);
+                    writer.Number(ROUND(wBarMax_,decimalDigitsToRound)); writer.Append(tab);
+                    writer.Integer(h); writer.Append(tab); writer.Append(c); writer.Append(tab);
+                    if(!(s.pNeutral())){writer.Number(ROUND(s.phat_,decimalDigitsToRound));}
+                    writer.Append(tab);
+                    if(!(s.qNeutral())){writer.Number(ROUND(s.qhat_,decimalDigitsToRound));}
+                    writer.Append(tab);
+                    writer.Number(ROUND(s.phBar_,decimalDigitsToRound)); writer.Append(tab); writer.Append(s.solutionGenotype());
+                    writer.Append(tab); writer.Append(s.solutionMismatchPattern()); writer.Append(tab);
+                    writer.Integer((long long)s.numReferenceGenotypes()); writer.Append(tab);
+                    writer.Append(firstRef); writer.Append(tab);
+                    long double landscape[18]={flp.wAABB_,flp.wAABb_,flp.wAAbb_,flp.wAaBB_,flp.wAaBb_,flp.wAabb_,
+                            flp.waaBB_,flp.waaBb_,flp.waabb_,
+                            flp.pAABB_,flp.pAABb_,flp.pAAbb_,flp.pAaBB_,flp.pAaBb_,flp.pAabb_,
+                            flp.paaBB_,flp.paaBb_,flp.paabb_};
+                    for(int k=0;k<18;++k){
+                        optional(landscape[k]);
+                        if(k<17){writer.Append(tab);}}
+                    writer.EndRow();
                     }//j
                 }//i
             }//h
-        }//PrintSolutionTableData
+        }//StreamSolutionTableData
+
+    void FinishPopt(BufferedTableWriter& writer, double Popt, double omega, double Ntf){
+        //streams this Popt's rows and drops them, ready for the next Popt
+        StreamSolutionTableData(writer,Popt,omega,Ntf);
+        if(logger.minSeverity_<=logInfo){//memory held for this Popt: the packed reference g'types against what the
+            //same list takes as strings (as it was kept before GenotypeKey), and the distinct landscapes
+            unsigned long packed=0, unpacked=0, asStrings=0, landscapes=0;
+            for(unsigned long h=0;h<solutionsByHetCode_.size();++h){
+                for(unsigned long i=0;i<solutionsByHetCode_[h].size();++i){
+                    FitnessMaximumBitstringSolution& s=solutionsByHetCode_[h][i];
+                    packed+=s.referenceGenotypes_.size();
+                    unpacked+=s.unpackedReferenceGenotypes_.size();
+                    landscapes+=s.fitnessLandscapesAndGPmaps_.size();
+                    if(s.referenceGenotypes_.size()>0){//every key has the same length of string
+                        asStrings+=s.referenceGenotypes_.size()*(sizeof(std::string)
+                                    +GenotypeKey::StringLength(s.referenceGenotypes_[0].bitstringLen())+1);}
+                    }
+                }//h
+            std::stringstream msg;
+            msg<<"all solutions for Popt="<<Popt<<": "<<items()<<" solution(s) from "<<packed+unpacked<<" reference g'types ("
+                <<packed*sizeof(GenotypeKey)<<" bytes packed, "<<asStrings<<" as strings";
+            if(unpacked>0){msg<<", "<<unpacked<<" too long to pack";}
+            msg<<"), "<<landscapes<<" fitness landscapes ("<<landscapes*sizeof(FitnessLandscapeParameters)<<" bytes)";
+            logger.Log(logInfo,msg.str());
+            }
+        ClearSolutions();
+        wBarMax_=-one;
+        }//FinishPopt
 
     void ReplaceWbarMax(long double newWbarMax){
-        solutionsByHetCode_.clear();
+        ClearSolutions();
         wBarMax_=newWbarMax;//error code
         }
     
@@ -1867,7 +3145,7 @@ public:
     
     
     void Reset(void){
-        solutionsByHetCode_.clear();
+        ClearSolutions();
         wBarMax_=Popt_=omega_= -one;//error code
         }
     
@@ -1933,8 +3211,9 @@ class FitnessMaximumSolutionSet{
     std::string mismatchHetPattern_;//3-character code
     std::string mismatchPattern_;//Mathematica-formatted code, e.g. {{0,0},{{0,0},{0,0}}}
     long numDuplicates_;//#reference genotypes giving this solution
-    std::string firstSolutionGtype_;
-    std::string firstRefGtype_;
+    std::string firstSolutionGtype_;//only used when the gtype doesn't fit a GenotypeKey;
+    std::string firstRefGtype_;//otherwise rendered from the keys on output
+    GenotypeKey firstSolutionKey_, firstRefKey_;
     int bitstringLen_;
     bool splitSinglePoptRun_;
     uint64_t startingTF0val_, endTF0val_;
@@ -2085,6 +3364,8 @@ class FitnessMaximumSolutionSet{
         numDuplicates_=fmss.numDuplicates_;
         firstSolutionGtype_=fmss.firstSolutionGtype_;
         firstRefGtype_=fmss.firstRefGtype_;
+        firstSolutionKey_=fmss.firstSolutionKey_;
+        firstRefKey_=fmss.firstRefKey_;
         bitstringLen_=fmss.bitstringLen_;
         splitSinglePoptRun_=fmss.splitSinglePoptRun_;
         startingTF0val_=fmss.startingTF0val_;
@@ -2111,6 +3392,8 @@ class FitnessMaximumSolutionSet{
         numDuplicates_=fmss.numDuplicates_;
         firstSolutionGtype_=fmss.firstSolutionGtype_;
         firstRefGtype_=fmss.firstRefGtype_;
+        firstSolutionKey_=fmss.firstSolutionKey_;
+        firstRefKey_=fmss.firstRefKey_;
         bitstringLen_=fmss.bitstringLen_;
         splitSinglePoptRun_=fmss.splitSinglePoptRun_;
         startingTF0val_=fmss.startingTF0val_;
@@ -2134,21 +3417,49 @@ class FitnessMaximumSolutionSet{
     std::string& mismatchHetPattern(void){return mismatchHetPattern_;}
     std::string& mismatchPattern(void){return mismatchPattern_;}
     long numDuplicates(void){return numDuplicates_;}
-    std::string& firstSolutionGtype(void){return firstSolutionGtype_;}
-    std::string& firstRefGtype(void){return firstRefGtype_;}
+    std::string firstSolutionGtype(void){
+        return firstSolutionKey_.packed() ? firstSolutionKey_.String() : firstSolutionGtype_;}
+    std::string firstRefGtype(void){
+        return firstRefKey_.packed() ? firstRefKey_.String() : firstRefGtype_;}
+
+    void SetFirstGtypes(SimplestRegPathIndividual& solutionIndiv, SimplestRegPathIndividual& refIndiv){
+        //keeps packed keys and leaves the strings to be rendered on output, unless the bitstrings are too long to pack
+        firstSolutionKey_=solutionIndiv.gtypeKey(bitstringLen_);
+        firstRefKey_=refIndiv.gtypeKey(bitstringLen_);
+        firstSolutionGtype_.clear(); firstRefGtype_.clear();
+        if(!firstSolutionKey_.packed()){
+            firstSolutionGtype_=solutionIndiv.gtypeString(bitstringLen_);
+            firstRefGtype_=refIndiv.gtypeString(bitstringLen_);}
+        }//SetFirstGtypes
 
     void Increment(void){
         numDuplicates_++;}
     
+    void Increment(long n){//for a solution that already stands for n reference g'types
+        numDuplicates_+=n;}
+    
+    uint64_t EqualityHash(void) const{
+        //hash of the fields operator== compares exactly, so equal solutions always hash alike;
+        //wBarMax_, meanPhenotype_, p_ & q_ are compared to within tol_, so they're left out and
+        //resolved by operator== within a bucket
+        std::hash<long double> hashLD;
+        std::hash<std::string> hashStr;
+        uint64_t h=hashLD(Popt_);
+        uint64_t parts[10]={hashLD(omega_),hashLD(Ntf_),(uint64_t)pNeutral_+2*(uint64_t)qNeutral_+4*(uint64_t)splitSinglePoptRun_,
+                (uint64_t)trueHetCode_,hashStr(trueHetPattern_),(uint64_t)mismatchHetCode_,hashStr(mismatchHetPattern_),
+                hashStr(mismatchPattern_),startingTF0val_,endTF0val_};
+        for(int i=0;i<10;++i){
+            h ^= parts[i]+0x9e3779b97f4a7c15ULL+(h<<6)+(h>>2);}
+        return h;}
+    
     void PrintDataLine(std::ostream& outfile){
         std::string tab("\t");
-        int Ntfint=(int)ROUND(Ntf_,0);
-        outfile<<Popt_<<tab<<omega_<<tab<<bitstringLen_<<tab<<Ntfint<<tab<<wBarMax_<<tab<<meanPhenotype_<<tab;
+        outfile<<Popt_<<tab<<omega_<<tab<<bitstringLen_<<tab<<Ntf_<<tab<<wBarMax_<<tab<<meanPhenotype_<<tab;
         outfile<<trueHetPattern_<<tab<<trueHetCode_<<tab;
         if(!(pNeutral_)){outfile<<p_;} outfile<<tab;
         if(!(qNeutral_)){outfile<<q_;} outfile<<tab;
         outfile<<mismatchHetPattern_<<tab<<mismatchHetCode_<<tab<<mismatchPattern_<<tab;
-        outfile<<firstSolutionGtype_<<tab<<firstRefGtype_<<tab<<numDuplicates_;
+        outfile<<firstSolutionGtype()<<tab<<firstRefGtype()<<tab<<numDuplicates_;
         if(splitSinglePoptRun_){
             outfile<<tab<<startingTF0val_<<tab<<endTF0val_;}
         outfile<<std::endl;
@@ -2192,6 +3503,7 @@ class FitnessMaximumSolutionSet{
         mismatchPattern_=mismatchPattern;
         firstSolutionGtype_=firstSolutionGtype;
         firstRefGtype_=firstRefGtype;
+        firstSolutionKey_=firstRefKey_=GenotypeKey();
         numDuplicates_=1;
         bitstringLen_=bitstringLen;
         }
@@ -2242,6 +3554,7 @@ class FitnessMaximaSolutionSets{
     std::vector<long double> wBarMaxPerPopt_;
     std::vector<long double> PoptValuesStored_;
     std::vector<std::vector<FitnessMaximumSolutionSet> > uniqueSolutionsByPopt_;//[Popt][solution]
+    std::vector<std::unordered_map<uint64_t,std::vector<int> > > solutionIndexByPopt_;//[Popt]: EqualityHash -> solutions
     bool splitSinglePoptRun_;
     uint64_t startingTF0val_, endTF0val_;
     
@@ -2255,6 +3568,7 @@ class FitnessMaximaSolutionSets{
         wBarMaxPerPopt_=fms.wBarMaxPerPopt_;
         PoptValuesStored_=fms.PoptValuesStored_;
         uniqueSolutionsByPopt_=fms.uniqueSolutionsByPopt_;
+        solutionIndexByPopt_=fms.solutionIndexByPopt_;
         splitSinglePoptRun_=fms.splitSinglePoptRun_;
         startingTF0val_=fms.startingTF0val_;
         endTF0val_=fms.endTF0val_;}
@@ -2265,6 +3579,7 @@ class FitnessMaximaSolutionSets{
         wBarMaxPerPopt_=fms.wBarMaxPerPopt_;
         PoptValuesStored_=fms.PoptValuesStored_;
         uniqueSolutionsByPopt_=fms.uniqueSolutionsByPopt_;
+        solutionIndexByPopt_=fms.solutionIndexByPopt_;
         splitSinglePoptRun_=fms.splitSinglePoptRun_;
         startingTF0val_=fms.startingTF0val_;
         endTF0val_=fms.endTF0val_;
@@ -2272,37 +3587,45 @@ class FitnessMaximaSolutionSets{
     
     public:
     
-    void AddSolution(FitnessMaximumSolutionSet& fmss){
+    int AddSolution(FitnessMaximumSolutionSet& fmss){//returns the row fmss went into at its Popt, or -1 if it's below the maximum
+        PhaseScope profile(bookkeepingPhase);
+        threadRunStatistics.addSolutionCalls_++;
         if(!(includesSolutionsForPopt(fmss.Popt()))){//make a new Popt and store this solution
             wBarMaxPerPopt_.push_back(fmss.wBarMax());
             PoptValuesStored_.push_back(fmss.Popt());
             std::vector<FitnessMaximumSolutionSet> v;
             v.push_back(fmss);
             uniqueSolutionsByPopt_.push_back(v);
-            return;}
+            solutionIndexByPopt_.push_back(std::unordered_map<uint64_t,std::vector<int> >());
+            solutionIndexByPopt_.back()[fmss.EqualityHash()].push_back(0);
+            return 0;}
         int p=indexForPopt(fmss.Popt());
         long double wMaxNew = fmss.wBarMax(), wMaxOld = uniqueSolutionsByPopt_[p][0].wBarMax();
-        if(wMaxNew<wMaxOld) return;//ignore
+        if(wMaxNew<wMaxOld) return -1;//ignore
         if(wMaxNew>wMaxOld){//clear old values
             wBarMaxPerPopt_[p]=wMaxNew;
             uniqueSolutionsByPopt_[p].clear();
             uniqueSolutionsByPopt_[p].push_back(fmss);
-            return;}
-        bool found=false;
-        for(int i=0;i<uniqueSolutionsByPopt_[p].size();++i){
-            if(fmss==uniqueSolutionsByPopt_[p][i]){//increment if it's already on the books
-                uniqueSolutionsByPopt_[p][i].Increment();
-                found=true;}
-            if(found)break;
-            }//i
-        if(!found){//it's unique, so add it
-            uniqueSolutionsByPopt_[p].push_back(fmss);}
+            solutionIndexByPopt_[p].clear();
+            solutionIndexByPopt_[p][fmss.EqualityHash()].push_back(0);
+            return 0;}
+        std::vector<int>& bucket=solutionIndexByPopt_[p][fmss.EqualityHash()];//only these can be equal
+        for(unsigned long b=0;b<bucket.size();++b){
+            if(fmss==uniqueSolutionsByPopt_[p][bucket[b]]){//increment if it's already on the books
+                uniqueSolutionsByPopt_[p][bucket[b]].Increment(fmss.numDuplicates_);//1 unless fmss is already a tally
+                return bucket[b];}
+            }//b
+        //it's unique, so add it
+        bucket.push_back((int)uniqueSolutionsByPopt_[p].size());
+        uniqueSolutionsByPopt_[p].push_back(fmss);
+        return bucket.back();
         }//AddSolution
 
 
     void ConcatenateSolutions(FitnessMaximaSolutionSets& fmsSets){
         for(int p=0;p<fmsSets.uniqueSolutionsByPopt_.size();++p){
             for(int fmss=0;fmss<fmsSets.uniqueSolutionsByPopt_[p].size();++fmss){
+                if(fmsSets.uniqueSolutionsByPopt_[p][fmss].numDuplicates_<1) continue;//every g'type it stood for was counted elsewhere
                 AddSolution(fmsSets.uniqueSolutionsByPopt_[p][fmss]);
                 }//fmss
             }//p
@@ -2320,6 +3643,7 @@ class FitnessMaximaSolutionSets{
         return -1;}
     
     void PrintDataByPopt(std::ostream& outfile, long double Popt){
+        PhaseScope profile(outputPhase);
         if(!(includesSolutionsForPopt(Popt)))return;
         int p = indexForPopt(Popt);
         for(int i=0;i<uniqueSolutionsByPopt_[p].size();++i){
@@ -2327,35 +3651,527 @@ class FitnessMaximaSolutionSets{
         }//PrintDataByPopt
 
 
-    void PrintHeaderLine(std::ostream& outfile){
-        outfile<<"Popt\tomega\tbitstring len\tNtfsat\twBarMax\tmean phenotype\thet pattern\thet code\tp\tq";
-        outfile<<"\tmismatch het pattern\tmismatch het code\tmismatch pattern\t";
-        outfile<<"1st solution g'type\t1st ref g'type\titems";
-        if(splitSinglePoptRun_){
-            outfile<<"\tstarting TF0\tend TF0";}
-        outfile<<std::endl;
-        }
+    void PrintHeaderLine(std::ostream& outfile, const std::string& itemsColumn="items"){//--search & --sample name what their items count
+        outfile<<"Popt\tomega\tbitstring len\tNtfsat\twBarMax\tmean phenotype\thet pattern\thet code\tp\tq";
+        outfile<<"\tmismatch het pattern\tmismatch het code\tmismatch pattern\t";
+        outfile<<"1st solution g'type\t1st ref g'type\t"<<itemsColumn;
+        if(splitSinglePoptRun_){
+            outfile<<"\tstarting TF0\tend TF0";}
+        outfile<<std::endl;
+        }
+
+    long double wBarMax(long double Popt){
+        int p = indexForPopt(Popt);
+        if(p==-1) {return -one;}
+        return wBarMaxPerPopt_[p];}
+    
+    std::string SolutionPatterns(long double Popt){//the winning het & mismatch patterns, sorted, so two Popts can be compared
+        int p = indexForPopt(Popt);
+        if(p==-1) {return "";}
+        std::vector<std::string> patterns;
+        for(unsigned long i=0;i<uniqueSolutionsByPopt_[p].size();++i){
+            patterns.push_back(uniqueSolutionsByPopt_[p][i].trueHetPattern_+" "+uniqueSolutionsByPopt_[p][i].mismatchPattern_);}
+        std::sort(patterns.begin(),patterns.end());
+        patterns.erase(std::unique(patterns.begin(),patterns.end()),patterns.end());
+        std::string joined;
+        for(unsigned long i=0;i<patterns.size();++i){
+            joined+=patterns[i]+";";}
+        return joined;}
+    
+    
+    friend int operator==(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2);
+    friend int operator!=(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2);
+    };// class FitnessMaximaSolutionSets
+
+
+
+
+
+int operator==(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2){
+    return (fms1.wBarMaxPerPopt_==fms2.wBarMaxPerPopt_ && fms1.PoptValuesStored_==fms2.PoptValuesStored_
+            && fms1.uniqueSolutionsByPopt_==fms2.uniqueSolutionsByPopt_);}
+
+int operator!=(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2){
+    return !(fms1==fms2);}
+
+
+
+class PoptResultStore{
+    //results for a grid of Popt values, keyed by the integer i in Popt=i/PoptSteps (as in main()'s loop),
+    //with one preallocated slot per grid point from PoptLow to PoptHigh in steps of PoptStepSize.
+    //each slot has its own lock, so runs for different Popts (or merges) can write at the same time
+    public:
+    int PoptLow_, PoptHigh_, PoptSteps_, PoptStepSize_;
+    std::vector<FitnessMaximaSolutionSets> slots_;
+    std::vector<bool> filled_;
+    std::vector<std::mutex> slotLocks_;
+    
+    public:
+    PoptResultStore(int PoptLow, int PoptHigh, int PoptSteps, int PoptStepSize, bool splitSinglePoptRun,
+                    uint64_t startingTF0val, uint64_t endTF0val):
+            PoptLow_(PoptLow),PoptHigh_(MAX(PoptLow,PoptHigh)),PoptSteps_(PoptSteps),PoptStepSize_(MAX(1,PoptStepSize)),
+            slots_((PoptHigh_-PoptLow_)/PoptStepSize_+1,FitnessMaximaSolutionSets(splitSinglePoptRun,startingTF0val,endTF0val)),
+            filled_(slots_.size(),false),slotLocks_(slots_.size()){}
+    
+    ~PoptResultStore(void){}
+    
+    public:
+    int numSlots(void){return (int)slots_.size();}
+    
+    int slotForIndex(int i){//-1 if i isn't on the grid
+        if(i<PoptLow_ || i>PoptHigh_ || (i-PoptLow_)%PoptStepSize_!=0) return -1;
+        return (i-PoptLow_)/PoptStepSize_;}
+    
+    int indexForSlot(int slot){
+        return PoptLow_+slot*PoptStepSize_;}
+    
+    long double Popt(int i){
+        return (long double)i/(long double)PoptSteps_;}
+    
+    bool Store(int i, FitnessMaximaSolutionSets& solutions){//adds (or merges in) the solutions for Popt=i/PoptSteps
+        int slot=slotForIndex(i);
+        if(slot==-1) return false;
+        std::lock_guard<std::mutex> lock(slotLocks_[slot]);
+        slots_[slot].ConcatenateSolutions(solutions);
+        filled_[slot]=true;
+        return true;}
+    
+    bool includesSolutionsForIndex(int i){
+        int slot=slotForIndex(i);
+        if(slot==-1) return false;
+        std::lock_guard<std::mutex> lock(slotLocks_[slot]);
+        return filled_[slot];}
+    
+    long double wBarMax(int i){//-1 if there's nothing stored for i
+        int slot=slotForIndex(i);
+        if(slot==-1) return -one;
+        std::lock_guard<std::mutex> lock(slotLocks_[slot]);
+        return slots_[slot].wBarMax(Popt(i));}
+    
+    void PrintDataByIndex(std::ostream& outfile, int i){
+        int slot=slotForIndex(i);
+        if(slot==-1) return;
+        std::lock_guard<std::mutex> lock(slotLocks_[slot]);
+        slots_[slot].PrintDataByPopt(outfile,Popt(i));}
+    
+    int RefinementPoints(int resolution, std::vector<int>& midpoints){
+        //for adaptive runs: the midpoint of each pair of neighbouring filled grid points that are more than resolution
+        //apart and don't have the same winning patterns, i.e. where a transition hasn't been pinned down yet
+        int added=0, previous=-1;
+        std::string previousPatterns;
+        for(int slot=0;slot<numSlots();++slot){
+            std::string patterns;
+            {std::lock_guard<std::mutex> lock(slotLocks_[slot]);
+                if(!filled_[slot]) continue;
+                patterns=slots_[slot].SolutionPatterns(Popt(indexForSlot(slot)));}
+            int i=indexForSlot(slot);
+            if(previous!=-1 && patterns!=previousPatterns && i-previous>resolution){
+                int m=previous+(i-previous)/2;
+                if(slotForIndex(m)!=-1){
+                    midpoints.push_back(m);
+                    ++added;}
+                }
+            previous=i;
+            previousPatterns=patterns;}
+        return added;}
+    };//class PoptResultStore
+
+
 
-    long double wBarMax(long double Popt){
-        int p = indexForPopt(Popt);
-        if(p==-1) {return -one;}
-        return wBarMaxPerPopt_[p];}
+
+enum summaryColumnType {ldColumn=1, int32Column=2, int64Column=3, uint8Column=4, dictCodeColumn=5, dictionaryBlob=6};
+
+class SummaryColumnEntry{//one entry of the directory at the start of the file
+    public:
+    char name_[24];
+    uint32_t type_;
+    uint32_t width_;//bytes per row; 0 for the dictionary
+    uint64_t offset_;//from the start of the file, 16-byte aligned
+    uint64_t bytes_;
+    };//SummaryColumnEntry
+
+class BinarySummaryTable{
+    //columnar copy of the summary table for downstream analysis & merging.
+    //layout: "FOSUMBIN", uint32 version, uint32 sizeof(long double), uint64 rows, uint32 columns,
+    //uint8 splitSinglePoptRun, uint8 header line in the text table, 2 spare bytes, then one SummaryColumnEntry
+    //per column and the 16-byte-aligned column data, so each column can be mmap'd as a plain array.
+    //long doubles are stored whole (not as doubles) so converting back to text reproduces the summary table
+    //byte for byte; readers on a platform with a different long double refuse the file.
+    //the string columns are int32 indices into one shared dictionary (uint32 count, then uint32 length + chars each)
+    public:
+    std::vector<long double> Popt_,omega_,Ntf_,wBarMax_,meanPhenotype_,p_,q_;
+    std::vector<int32_t> bitstringLen_,trueHetCode_,mismatchHetCode_;
+    std::vector<int64_t> numDuplicates_,startingTF0val_,endTF0val_;
+    std::vector<uint8_t> pNeutral_,qNeutral_;
+    std::vector<int32_t> trueHetPattern_,mismatchHetPattern_,mismatchPattern_,firstSolutionGtype_,firstRefGtype_;
+    std::vector<std::string> dictionary_;
+    std::unordered_map<std::string,int32_t> dictionaryIndex_;
+    bool splitSinglePoptRun_, headerInTable_;
+    static const uint32_t version_=1;
     
+    public:
+    BinarySummaryTable(void):splitSinglePoptRun_(false),headerInTable_(true){}
+    ~BinarySummaryTable(void){}
     
-    friend int operator==(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2);
-    friend int operator!=(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2);
-    };// class FitnessMaximaSolutionSets
+    public:
+    unsigned long rows(void){return Popt_.size();}
+    
+    int32_t Encode(const std::string& text){
+        std::unordered_map<std::string,int32_t>::iterator it=dictionaryIndex_.find(text);
+        if(it!=dictionaryIndex_.end()) return it->second;
+        int32_t code=(int32_t)dictionary_.size();
+        dictionary_.push_back(text);
+        dictionaryIndex_[text]=code;
+        return code;}
+    
+    void AppendRow(FitnessMaximumSolutionSet& fmss){
+        Popt_.push_back(fmss.Popt_); omega_.push_back(fmss.omega_); Ntf_.push_back(fmss.Ntf_);
+        wBarMax_.push_back(fmss.wBarMax_); meanPhenotype_.push_back(fmss.meanPhenotype_);
+        p_.push_back(fmss.p_); q_.push_back(fmss.q_);
+        pNeutral_.push_back(fmss.pNeutral_); qNeutral_.push_back(fmss.qNeutral_);
+        bitstringLen_.push_back(fmss.bitstringLen_);
+        trueHetCode_.push_back(fmss.trueHetCode_); mismatchHetCode_.push_back(fmss.mismatchHetCode_);
+        numDuplicates_.push_back(fmss.numDuplicates_);
+        startingTF0val_.push_back((int64_t)fmss.startingTF0val_); endTF0val_.push_back((int64_t)fmss.endTF0val_);
+        trueHetPattern_.push_back(Encode(fmss.trueHetPattern_));
+        mismatchHetPattern_.push_back(Encode(fmss.mismatchHetPattern_));
+        mismatchPattern_.push_back(Encode(fmss.mismatchPattern_));
+        firstSolutionGtype_.push_back(Encode(fmss.firstSolutionGtype()));
+        firstRefGtype_.push_back(Encode(fmss.firstRefGtype()));}
+    
+    void AppendRows(FitnessMaximaSolutionSets& fms, long double Popt){//in PrintDataByPopt() order
+        if(!fms.includesSolutionsForPopt(Popt)) return;
+        int p=fms.indexForPopt(Popt);
+        for(unsigned long i=0;i<fms.uniqueSolutionsByPopt_[p].size();++i){
+            AppendRow(fms.uniqueSolutionsByPopt_[p][i]);}
+        }
+    
+    FitnessMaximumSolutionSet Row(unsigned long r){
+        FitnessMaximumSolutionSet fmss(bitstringLen_[r],splitSinglePoptRun_,(uint64_t)startingTF0val_[r],(uint64_t)endTF0val_[r]);
+        fmss.Popt_=Popt_[r]; fmss.omega_=omega_[r]; fmss.Ntf_=Ntf_[r];
+        fmss.wBarMax_=wBarMax_[r]; fmss.meanPhenotype_=meanPhenotype_[r];
+        fmss.p_=p_[r]; fmss.q_=q_[r]; fmss.pNeutral_=pNeutral_[r]; fmss.qNeutral_=qNeutral_[r];
+        fmss.trueHetCode_=trueHetCode_[r]; fmss.mismatchHetCode_=mismatchHetCode_[r];
+        fmss.numDuplicates_=(long)numDuplicates_[r];
+        fmss.trueHetPattern_=dictionary_[trueHetPattern_[r]];
+        fmss.mismatchHetPattern_=dictionary_[mismatchHetPattern_[r]];
+        fmss.mismatchPattern_=dictionary_[mismatchPattern_[r]];
+        fmss.firstSolutionGtype_=dictionary_[firstSolutionGtype_[r]];
+        fmss.firstRefGtype_=dictionary_[firstRefGtype_[r]];
+        return fmss;}
+    
+    int Write(std::string fileName){//-1 if the file can't be written
+        //written to fileName.tmp & renamed over fileName, so a reader (or a killed run) never sees half a table
+        std::vector<SummaryColumnEntry> entries;
+        std::vector<const char*> data;
+        std::string dictionaryBytes;
+        uint32_t count=(uint32_t)dictionary_.size();
+        dictionaryBytes.append((const char*)&count,sizeof(count));
+        for(unsigned long d=0;d<dictionary_.size();++d){
+            uint32_t len=(uint32_t)dictionary_[d].size();
+            dictionaryBytes.append((const char*)&len,sizeof(len));
+            dictionaryBytes+=dictionary_[d];}
+        auto column=[&entries,&data](const char* name, summaryColumnType type, uint32_t width, const void* values, uint64_t bytes){
+            SummaryColumnEntry e; std::memset(&e,0,sizeof(e));
+            std::strncpy(e.name_,name,sizeof(e.name_)-1);
+            e.type_=type; e.width_=width; e.bytes_=bytes;
+            entries.push_back(e); data.push_back((const char*)values);};
+        uint64_t n=rows();
+        column("Popt",ldColumn,sizeof(long double),Popt_.data(),n*sizeof(long double));
+        column("omega",ldColumn,sizeof(long double),omega_.data(),n*sizeof(long double));
+        column("bitstring len",int32Column,4,bitstringLen_.data(),n*4);
+        column("Ntfsat",ldColumn,sizeof(long double),Ntf_.data(),n*sizeof(long double));
+        column("wBarMax",ldColumn,sizeof(long double),wBarMax_.data(),n*sizeof(long double));
+        column("mean phenotype",ldColumn,sizeof(long double),meanPhenotype_.data(),n*sizeof(long double));
+        column("het pattern",dictCodeColumn,4,trueHetPattern_.data(),n*4);
+        column("het code",int32Column,4,trueHetCode_.data(),n*4);
+        column("p",ldColumn,sizeof(long double),p_.data(),n*sizeof(long double));
+        column("p neutral",uint8Column,1,pNeutral_.data(),n);
+        column("q",ldColumn,sizeof(long double),q_.data(),n*sizeof(long double));
+        column("q neutral",uint8Column,1,qNeutral_.data(),n);
+        column("mismatch het pattern",dictCodeColumn,4,mismatchHetPattern_.data(),n*4);
+        column("mismatch het code",int32Column,4,mismatchHetCode_.data(),n*4);
+        column("mismatch pattern",dictCodeColumn,4,mismatchPattern_.data(),n*4);
+        column("1st solution g'type",dictCodeColumn,4,firstSolutionGtype_.data(),n*4);
+        column("1st ref g'type",dictCodeColumn,4,firstRefGtype_.data(),n*4);
+        column("items",int64Column,8,numDuplicates_.data(),n*8);
+        column("starting TF0",int64Column,8,startingTF0val_.data(),n*8);
+        column("end TF0",int64Column,8,endTF0val_.data(),n*8);
+        column("dictionary",dictionaryBlob,0,dictionaryBytes.data(),dictionaryBytes.size());
+        
+        uint64_t offset=32+entries.size()*sizeof(SummaryColumnEntry);
+        for(unsigned long c=0;c<entries.size();++c){
+            offset=(offset+15)&~uint64_t(15);
+            entries[c].offset_=offset;
+            offset+=entries[c].bytes_;}
+        std::string tmpName=fileName+".tmp";
+        std::ofstream out(tmpName.c_str(),std::ios::binary|std::ios::trunc);
+        if(!out.is_open()) return -1;
+        uint32_t version=version_, ldBytes=sizeof(long double), numColumns=(uint32_t)entries.size();
+        uint8_t flags[4]={(uint8_t)splitSinglePoptRun_,(uint8_t)headerInTable_,0,0};
+        out.write("FOSUMBIN",8);
+        out.write((const char*)&version,4); out.write((const char*)&ldBytes,4);
+        out.write((const char*)&n,8); out.write((const char*)&numColumns,4); out.write((const char*)flags,4);
+        out.write((const char*)entries.data(),entries.size()*sizeof(SummaryColumnEntry));
+        uint64_t at=32+entries.size()*sizeof(SummaryColumnEntry);
+        const char padding[16]={0};
+        for(unsigned long c=0;c<entries.size();++c){
+            out.write(padding,entries[c].offset_-at);
+            out.write(data[c],entries[c].bytes_);
+            at=entries[c].offset_+entries[c].bytes_;}
+        out.close();
+        if(out.fail()){
+            std::remove(tmpName.c_str());
+            return -1;}
+        return (std::rename(tmpName.c_str(),fileName.c_str())==0) ? 0 : -1;}
+    
+    int Read(std::string fileName){//-1 if the file is missing, truncated or from an incompatible platform
+        std::ifstream in(fileName.c_str(),std::ios::binary);
+        if(!in.is_open()) return -1;
+        std::string bytes((std::istreambuf_iterator<char>(in)),std::istreambuf_iterator<char>());
+        if(bytes.size()<32 || bytes.compare(0,8,"FOSUMBIN")!=0) return -1;
+        uint32_t version,ldBytes,numColumns; uint64_t n;
+        std::memcpy(&version,&bytes[8],4); std::memcpy(&ldBytes,&bytes[12],4);
+        std::memcpy(&n,&bytes[16],8); std::memcpy(&numColumns,&bytes[24],4);
+        if(version!=version_ || ldBytes!=sizeof(long double)) return -1;
+        if(bytes.size()<32+(uint64_t)numColumns*sizeof(SummaryColumnEntry)) return -1;
+        std::vector<SummaryColumnEntry> entries(numColumns);
+        std::memcpy(entries.data(),&bytes[32],numColumns*sizeof(SummaryColumnEntry));
+        *this=BinarySummaryTable();
+        splitSinglePoptRun_=bytes[28]; headerInTable_=bytes[29];
+        for(unsigned long c=0;c<entries.size();++c){
+            SummaryColumnEntry& e=entries[c];
+            if(e.offset_+e.bytes_>bytes.size()) return -1;
+            if(e.type_!=dictionaryBlob && e.bytes_!=n*e.width_) return -1;
+            const char* src=&bytes[e.offset_];
+            std::string name(e.name_,strnlen(e.name_,sizeof(e.name_)));
+            auto fill=[&src,&e](auto& vec){
+                vec.resize(e.bytes_/sizeof(vec[0]));
+                std::memcpy(vec.data(),src,e.bytes_);};
+            if(name=="Popt") fill(Popt_);
+            else if(name=="omega") fill(omega_);
+            else if(name=="bitstring len") fill(bitstringLen_);
+            else if(name=="Ntfsat") fill(Ntf_);
+            else if(name=="wBarMax") fill(wBarMax_);
+            else if(name=="mean phenotype") fill(meanPhenotype_);
+            else if(name=="het pattern") fill(trueHetPattern_);
+            else if(name=="het code") fill(trueHetCode_);
+            else if(name=="p") fill(p_);
+            else if(name=="p neutral") fill(pNeutral_);
+            else if(name=="q") fill(q_);
+            else if(name=="q neutral") fill(qNeutral_);
+            else if(name=="mismatch het pattern") fill(mismatchHetPattern_);
+            else if(name=="mismatch het code") fill(mismatchHetCode_);
+            else if(name=="mismatch pattern") fill(mismatchPattern_);
+            else if(name=="1st solution g'type") fill(firstSolutionGtype_);
+            else if(name=="1st ref g'type") fill(firstRefGtype_);
+            else if(name=="items") fill(numDuplicates_);
+            else if(name=="starting TF0") fill(startingTF0val_);
+            else if(name=="end TF0") fill(endTF0val_);
+            else if(name=="dictionary"){
+                uint64_t at=4; uint32_t count;
+                if(e.bytes_<4) return -1;
+                std::memcpy(&count,src,4);
+                for(uint32_t d=0;d<count;++d){
+                    uint32_t len;
+                    if(at+4>e.bytes_) return -1;
+                    std::memcpy(&len,src+at,4); at+=4;
+                    if(at+len>e.bytes_) return -1;
+                    dictionary_.push_back(std::string(src+at,len)); at+=len;}
+                }
+            }//c
+        std::vector<int32_t>* codes[5]={&trueHetPattern_,&mismatchHetPattern_,&mismatchPattern_,&firstSolutionGtype_,&firstRefGtype_};
+        for(int k=0;k<5;++k){
+            if(codes[k]->size()!=n) return -1;
+            for(uint64_t r=0;r<n;++r){
+                if((*codes[k])[r]<0 || (*codes[k])[r]>=(int32_t)dictionary_.size()) return -1;}
+            }
+        if(Popt_.size()!=n || omega_.size()!=n || Ntf_.size()!=n || wBarMax_.size()!=n || meanPhenotype_.size()!=n
+           || p_.size()!=n || q_.size()!=n || pNeutral_.size()!=n || qNeutral_.size()!=n || bitstringLen_.size()!=n
+           || trueHetCode_.size()!=n || mismatchHetCode_.size()!=n || numDuplicates_.size()!=n
+           || startingTF0val_.size()!=n || endTF0val_.size()!=n) return -1;
+        return 0;}
+    
+    void PrintTable(std::ostream& outfile){//the fitnessOverdomSummaryTable text, as main() writes it
+        if(headerInTable_){
+            FitnessMaximaSolutionSets headerOnly(splitSinglePoptRun_,0,0);
+            headerOnly.PrintHeaderLine(outfile);}
+        for(unsigned long r=0;r<rows();++r){
+            Row(r).PrintDataLine(outfile);}
+        }
+    };//class BinarySummaryTable
 
 
+int ConvertBinarySummaryToTSV(std::string binName, std::string tsvName){
+    BinarySummaryTable table;
+    if(table.Read(binName)==-1){
+        logger.Log(logError,"can't read binary summary table "+binName,true);
+        return -1;}
+    std::fstream outfile(tsvName.c_str(),std::fstream::out);
+    if(!outfile.is_open()){
+        logger.Log(logError,"can't open "+tsvName,true);
+        return -1;}
+    table.PrintTable(outfile);
+    outfile.close();
+    return 0;
+    }//ConvertBinarySummaryToTSV
 
 
 
-int operator==(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2){
-    return (fms1.wBarMaxPerPopt_==fms2.wBarMaxPerPopt_ && fms1.PoptValuesStored_==fms2.PoptValuesStored_
-            && fms1.uniqueSolutionsByPopt_==fms2.uniqueSolutionsByPopt_);}
 
-int operator!=(FitnessMaximaSolutionSets& fms1, FitnessMaximaSolutionSets& fms2){
-    return !(fms1==fms2);}
+class SharedResultsRecord{
+    //one shard's results for one Popt, as kept in the shared results log.
+    //on disk: "FOLR", uint32 payload bytes, uint64 FNV-1a checksum of the payload, then the payload:
+    //int32 Popt index, int32 PoptSteps, uint64 first & last TF0 value, uint8 splitSinglePoptRun, 7 spare bytes,
+    //double wBarMax, and the shard's summary table lines for this Popt (PrintDataLine() text)
+    public:
+    int32_t PoptIndex_, PoptSteps_;
+    uint64_t startingTF0val_, endTF0val_;
+    bool splitSinglePoptRun_;
+    double wBarMax_;
+    std::string rows_;
+    static const uint64_t fixedBytes_=40;//payload before rows_
+    
+    public:
+    SharedResultsRecord(void):PoptIndex_(0),PoptSteps_(1),startingTF0val_(0),endTF0val_(0),splitSinglePoptRun_(false),wBarMax_(-1){}
+    ~SharedResultsRecord(void){}
+    
+    public:
+    long double Popt(void){return (long double)PoptIndex_/(long double)PoptSteps_;}
+    
+    std::string Encode(void){
+        std::string payload(fixedBytes_,'\0');
+        std::memcpy(&payload[0],&PoptIndex_,4); std::memcpy(&payload[4],&PoptSteps_,4);
+        std::memcpy(&payload[8],&startingTF0val_,8); std::memcpy(&payload[16],&endTF0val_,8);
+        payload[24]=(char)splitSinglePoptRun_;
+        std::memcpy(&payload[32],&wBarMax_,8);
+        payload+=rows_;
+        uint32_t bytes=(uint32_t)payload.size();
+        uint64_t checksum=Fnv1a64(payload.data(),payload.size());
+        std::string record("FOLR");
+        record.append((const char*)&bytes,4);
+        record.append((const char*)&checksum,8);
+        return record+payload;}
+    
+    bool Decode(const std::string& log, uint64_t at, uint64_t& recordBytes){
+        //false if there's no intact record starting at log[at]
+        if(at+16>log.size() || log.compare(at,4,"FOLR")!=0) return false;
+        uint32_t bytes; uint64_t checksum;
+        std::memcpy(&bytes,&log[at+4],4); std::memcpy(&checksum,&log[at+8],8);
+        if(bytes<fixedBytes_ || at+16+bytes>log.size()) return false;
+        const char* payload=&log[at+16];
+        if(Fnv1a64(payload,bytes)!=checksum) return false;
+        std::memcpy(&PoptIndex_,payload,4); std::memcpy(&PoptSteps_,payload+4,4);
+        std::memcpy(&startingTF0val_,payload+8,8); std::memcpy(&endTF0val_,payload+16,8);
+        splitSinglePoptRun_=payload[24];
+        std::memcpy(&wBarMax_,payload+32,8);
+        rows_.assign(payload+fixedBytes_,bytes-fixedBytes_);
+        recordBytes=16+bytes;
+        return PoptSteps_>0;}
+    };//SharedResultsRecord
+
+
+class SharedResultsLog{
+    //one file that every shard process appends its per-Popt results to, instead of each writing its own summary table.
+    //each record goes out in a single write() to an O_APPEND descriptor, so records from different processes
+    //never interleave (on a local or cluster filesystem with POSIX append semantics; not NFS)
+    public:
+    int fd_;
+    std::string fileName_;
+    
+    public:
+    SharedResultsLog(void):fd_(-1){}
+    ~SharedResultsLog(void){Close();}
+    
+    public:
+    bool isOpen(void){return fd_!=-1;}
+    
+    int Open(std::string fileName){//-1 on failure
+        fileName_=fileName;
+#if defined(__unix__) || defined(__APPLE__)
+        fd_=open(fileName.c_str(),O_WRONLY|O_APPEND|O_CREAT,0644);
+#endif
+        return isOpen() ? 0 : -1;}
+    
+    int Append(SharedResultsRecord& rec){//-1 if the record couldn't be written whole
+        if(!isOpen()) return -1;
+        std::string bytes=rec.Encode();
+#if defined(__unix__) || defined(__APPLE__)
+        ssize_t written=write(fd_,bytes.data(),bytes.size());
+        if(written==(ssize_t)bytes.size()) return 0;
+#endif
+        return -1;}
+    
+    void Close(void){
+#if defined(__unix__) || defined(__APPLE__)
+        if(isOpen()){close(fd_);}
+#endif
+        fd_=-1;}
+    };//SharedResultsLog
+
+
+int ReconstructMaximaFromSharedLog(std::string logName, std::string tsvName){
+    //writes the summary table for every Popt in the log, keeping only the shards that reach that Popt's
+    //highest wBarMax (to within FitnessMaximumSolutionSet::tol_). a shard that was rerun keeps its last record;
+    //damaged stretches (e.g. a process killed mid-write on a filesystem without atomic appends) are skipped
+    std::ifstream in(logName.c_str(),std::ios::binary);
+    if(!in.is_open()){
+        logger.Log(logError,"can't read shared results log "+logName,true);
+        return -1;}
+    std::string log((std::istreambuf_iterator<char>(in)),std::istreambuf_iterator<char>());
+    in.close();
+    std::vector<SharedResultsRecord> records;
+    std::map<std::vector<uint64_t>,int> recordForShard;//{Popt index, PoptSteps, first TF0, last TF0} -> records
+    uint64_t at=0, damagedBytes=0, reruns=0;
+    bool splitSinglePoptRun=false;
+    while(at<log.size()){
+        SharedResultsRecord rec;
+        uint64_t recordBytes=0;
+        if(!rec.Decode(log,at,recordBytes)){//resync at the next record marker
+            uint64_t next=log.find("FOLR",at+1);
+            if(next==std::string::npos){next=log.size();}
+            damagedBytes+=next-at;
+            at=next;
+            continue;}
+        at+=recordBytes;
+        splitSinglePoptRun = splitSinglePoptRun || rec.splitSinglePoptRun_;
+        std::vector<uint64_t> shard={(uint64_t)rec.PoptIndex_,(uint64_t)rec.PoptSteps_,rec.startingTF0val_,rec.endTF0val_};
+        std::map<std::vector<uint64_t>,int>::iterator it=recordForShard.find(shard);
+        if(it!=recordForShard.end()){
+                records[it->second]=rec; reruns++;}
+            else{
+                recordForShard[shard]=(int)records.size(); records.push_back(rec);}
+        }
+    std::sort(records.begin(),records.end(),[](SharedResultsRecord& a, SharedResultsRecord& b){
+        long double pa=a.Popt(), pb=b.Popt();
+        if(pa!=pb) return pa<pb;
+        return a.startingTF0val_<b.startingTF0val_;});
+    std::fstream outfile(tsvName.c_str(),std::fstream::out);
+    if(!outfile.is_open()){
+        logger.Log(logError,"can't open "+tsvName,true);
+        return -1;}
+    FitnessMaximaSolutionSets headerOnly(splitSinglePoptRun,0,0);
+    headerOnly.PrintHeaderLine(outfile);
+    int numPopts=0;
+    for(unsigned long r=0;r<records.size();){
+        unsigned long end=r;
+        double wBarMax=-one;
+        while(end<records.size() && records[end].Popt()==records[r].Popt()){
+            wBarMax=MAX(wBarMax,records[end].wBarMax_); ++end;}
+        for(unsigned long k=r;k<end;++k){
+            if(ABS(records[k].wBarMax_-wBarMax)<=FitnessMaximumSolutionSet::tol_){
+                outfile<<records[k].rows_;}
+            }
+        numPopts++;
+        r=end;}
+    outfile.close();
+    std::stringstream report;
+    report<<logName<<": "<<records.size()<<" shard records for "<<numPopts<<" Popt values";
+    if(reruns>0){report<<", "<<reruns<<" superseded by reruns";}
+    if(damagedBytes>0){report<<", "<<damagedBytes<<" damaged bytes skipped";}
+    logger.Log(logInfo,report.str());
+    return 0;
+    }//ReconstructMaximaFromSharedLog
 
 
 
@@ -2639,6 +4455,7 @@ get the final maximum.
 */
 	int maxRepeatsWithoutImprovement=100;
 	nFuntionCalls=0;
+	threadRunStatistics.amoebaCalls_++;
 	int repeatsWithoutImprovement=0, iterations=0;
 	bool maximized=false,betterPointFound=false;
 	long double pAtABmidpoint,qAtABmidpoint;
@@ -2686,23 +4503,31 @@ get the final maximum.
 					maximized=true;}
 				}
 		if(!maximized && repeatsWithoutImprovement>=maxRepeatsWithoutImprovement){
-            coutLock.lock();
-            std::cout<<"can\'t maximize fitness for case where";
-			std::cout<<" w0000="<<w0000;
-			std::cout<<"; w0001="<<w0001;
-			std::cout<<"; w0011="<<w0011;
-			std::cout<<"; w0100="<<w0100;
-			std::cout<<"; w0100="<<w0101;
-			std::cout<<"; w0100="<<w0111;
-			std::cout<<"; w1100="<<w1100;
-			std::cout<<"; w1100="<<w1101;
-			std::cout<<"; w1100="<<w1111;
-			std::cout<<std::endl;
-			std::cout<<"Skipping this case"<<std::endl;
-            coutLock.unlock();
+            static LogRateLimit nonConvergenceLimit(10,1000);
+            uint64_t occurrence;
+            if(nonConvergenceLimit.Allow(occurrence)){
+                std::stringstream msg;
+                msg<<"can\'t maximize fitness for case where";
+                msg<<" w0000="<<w0000;
+                msg<<"; w0001="<<w0001;
+                msg<<"; w0011="<<w0011;
+                msg<<"; w0100="<<w0100;
+                msg<<"; w0100="<<w0101;
+                msg<<"; w0100="<<w0111;
+                msg<<"; w1100="<<w1100;
+                msg<<"; w1100="<<w1101;
+                msg<<"; w1100="<<w1111;
+                msg<<std::endl;
+                msg<<"Skipping this case";
+                if(occurrence>nonConvergenceLimit.firstN_){
+                    msg<<" (case "<<occurrence<<"; only every "<<nonConvergenceLimit.everyN_<<"th is reported)";}
+                logger.Log(logWarning,msg.str());}
+			threadRunStatistics.amoebaIterations_+=iterations;
+			threadRunStatistics.amoebaNonConvergence_++;
 			return 0;
 			}//too many repeats without improvement
 		}//while !maximized
+	threadRunStatistics.amoebaIterations_+=iterations;
 	return 1;
 	}//end function amoeba
 
@@ -2801,7 +4626,7 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
 								 long double waaBB,long double waaBb,long double waabb,long double& wBarMax,
                                   std::vector<long double>& phat, std::vector<long double>& qhat,
                                   std::vector<bool>& pNeutral, std::vector<bool>& qNeutral,
-                                  int& numMaxima, std::string& focalGtypeStr){
+                                  int& numMaxima, GenotypeKey& focalGtype){
 	//find wBar at the 4 corners, then maximize wBar starting at p[A]=q[B]=0.5.  Finally, compare all 5 to get maximum
 	//need to do this because fitness surface can be convex in the middle, but still highest in one of the corners
 	//returns 0 if maximization fails; 1 otherwise
@@ -3060,10 +4885,14 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
 						solutionFound=true;
 						}
 					else{//neutral loci: corners and edges have equal maxima (which might be duplicates)
-						coutLock.lock();
-                        std::cout<<"Error in MaximizePopMeanFitnessPandQv2(): can't handle cases where wbar is maximal both in corner(s) and edge(s)"<<std::endl;
-                        std::cout<<"                               for ref gtype="<<focalGtypeStr<<std::endl;
-                        coutLock.unlock();
+                        static LogRateLimit cornerAndEdgeLimit(10,1000);
+                        uint64_t occurrence;
+                        if(cornerAndEdgeLimit.Allow(occurrence)){
+                            std::stringstream msg;
+                            msg<<"Error in MaximizePopMeanFitnessPandQv2(): can't handle cases where wbar is maximal both in corner(s) and edge(s)"<<std::endl;
+                            msg<<"                               for ref gtype="<<focalGtype.String();
+                            if(occurrence>cornerAndEdgeLimit.firstN_){msg<<" (case "<<occurrence<<")";}
+                            logger.Log(logWarning,msg.str());}
                         if(wAABB==wAABb && wAABB==wAAbb){//cis locus is neutral
                             qhat[0]=two;
                             MaximizePopMeanFitnessP(wAABB,wAaBB,waaBB,wbarEdge,pEdges,pNeutralEdges,localMaxima);
@@ -3200,7 +5029,7 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
                                     solutionFound=true;}
                                 }
                             else{
-                                coutLock.lock(); std::cout<<"shouldn't reach this point"<<std::endl; coutLock.unlock();}
+                                logger.Log(logError,"MaximizePopMeanFitnessPandQv2(): shouldn't reach this point");}
                         }//equal & not adjacent
                         
                     }//numBestCorners==2
@@ -3511,9 +5340,7 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
                        }
                     }
                 else{
-                    coutLock.lock();
-                    std::cout<<"3-site case indicated but no 3-site combination found; shouldn't get here"<<std::endl;
-                    coutLock.unlock();
+                    logger.Log(logError,"3-site case indicated but no 3-site combination found; shouldn't get here");
                 }
                 //potential cases:
                     //just the corners are high
@@ -3521,7 +5348,9 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
                 //more than one locus can be neutral when the other is not, but both can't be neutral sinultaneously
                 }
             else if(numBestCorners==4){
-                coutLock.lock(); std::cout<<"4 best corners"<<std::endl; coutLock.unlock();
+                static LogRateLimit fourCornersLimit(10,1000);
+                uint64_t occurrence;
+                if(fourCornersLimit.Allow(occurrence)){logger.Log(logInfo,"4 best corners");}
                 //potential cases:
                 
                     if(waabb>=wAaBb){
@@ -3714,7 +5543,14 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
 		int converged=amoeba(wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb,
 									 wbarABC,pABC,qABC,convergenceBracket,nFuntionCalls);
 		if(!converged){
-			coutLock.lock(); std::cout<<"MaximizePopMeanFitnessPandQv2(...) failed to converge"<<std::endl; coutLock.unlock();}
+			static LogRateLimit failedToConvergeLimit(10,1000);
+			uint64_t occurrence;
+			if(failedToConvergeLimit.Allow(occurrence)){
+				std::stringstream msg;
+				msg<<"MaximizePopMeanFitnessPandQv2(...) failed to converge";
+				if(occurrence>failedToConvergeLimit.firstN_){msg<<" ("<<occurrence<<" times so far)";}
+				logger.Log(logWarning,msg.str());}
+			}
 		long double wBarAtBestMiddle,coordsAtHighestMiddle[2];
 		wBarAtBestMiddle=wbarABC[0];
 		coordsAtHighestMiddle[0]=pABC[0];
@@ -3790,9 +5626,265 @@ int MaximizePopMeanFitnessPandQv2(long double wAABB,long double wAABb,long doubl
 
 
 
-void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIndivP, simulationSettings* simSetP,
+class HetCodeMaxima{
+    //--het-code-maxima: the best wBar each het code (see codeToInt()) reaches in one sweep, & a reference g'type that
+    //reaches it, instead of rerunning a restricted model per code. every reference g'type records its own solutions,
+    //not just those tying the running maximum. each code's best is one atomic word, the rounded wBar in units of
+    //10^-decimalDigitsToRound (+1, so 0 means none) above an index into examples_, so the threads raise it with a
+    //compare-exchange & never wait on each other; an example is written to its own slot before it's published.
+    //the index (below examplesKept_, or noExample_) fits in 20 bits, leaving 44 for the level: enough for
+    //decimalDigitsToRound up to 13; Reset() refuses anything finer
+    public:
+    static const int numHetCodes_=27;
+    static const int indexBits_=20;
+    static const uint64_t noExample_=(((uint64_t)1)<<indexBits_)-1;
+    static const uint64_t examplesKept_=1<<16;//improvements are rare; past this, a code's best is kept without an example
+    bool enabled_;
+    std::atomic<uint64_t> best_[numHetCodes_];
+    std::atomic<uint64_t> numExamples_;
+    std::vector<uint64_t> examples_;//6 bitstrings per example
+    long double scale_;//10^decimalDigitsToRound, set by Reset()
+
+    public:
+    HetCodeMaxima(void):enabled_(false),numExamples_(0),scale_(one){
+        for(int h=0;h<numHetCodes_;++h){best_[h]=0;}
+        }
+    ~HetCodeMaxima(void){}
+
+    public:
+    int Reset(void){//before each Popt; -1 if decimalDigitsToRound is too fine for the packed levels
+        for(int h=0;h<numHetCodes_;++h){best_[h]=0;}
+        numExamples_=0;
+        if(examples_.size()==0){examples_.resize(6*examplesKept_);}
+        scale_=powl(ten,(long double)decimalDigitsToRound);
+        if(scale_+one>=ldexpl(one,64-indexBits_)) return -1;//wBar=1 must fit above the index
+        return 0;
+        }
+
+    void Record(int hetCode, long double wBar, SimplestRegPathIndividual& reference){
+        if(hetCode<0 || hetCode>=numHetCodes_ || wBar<zero) return;
+        uint64_t level=(uint64_t)llroundl(wBar*scale_)+1;
+        uint64_t current=best_[hetCode].load(std::memory_order_relaxed);
+        if((current>>indexBits_)>=level) return;//the usual case
+        uint64_t id=numExamples_.fetch_add(1,std::memory_order_relaxed);
+        if(id<examplesKept_){
+                uint64_t* g=&(examples_[6*id]);
+                g[0]=reference.TFdosage_[0]; g[1]=reference.TFdosage_[1];
+                g[2]=reference.TFproduct_[0]; g[3]=reference.TFproduct_[1];
+                g[4]=reference.cis_[0]; g[5]=reference.cis_[1];}
+            else{
+                id=noExample_;}
+        uint64_t wanted=(level<<indexBits_)|id;
+        while((current>>indexBits_)<level &&
+              !best_[hetCode].compare_exchange_weak(current,wanted,std::memory_order_release,std::memory_order_relaxed)){}
+        }//Record
+
+    long double wBar(int hetCode){
+        uint64_t level=best_[hetCode].load()>>indexBits_;
+        if(level==0) return -one;
+        return (long double)(level-1)/scale_;}
+
+    void PrintHeaderLine(std::ostream& outfile){
+        outfile<<"Popt\tomega\tbitstringLen\tNtf\thet pattern\thet code\twBar\twBarMax - wBar\texample reference g'type"<<std::endl;}
+
+    void Write(std::ostream& outfile, simulationSettings& simSet){//after the sweep for a Popt has joined its threads
+        std::string tab("\t");
+        long double wBarMax=-one;
+        for(int h=0;h<numHetCodes_;++h){wBarMax=MAX(wBarMax,wBar(h));}
+        int reached=0;
+        for(int h=0;h<numHetCodes_;++h){
+            long double w=wBar(h);
+            if(w<zero) continue;
+            reached++;
+            int hc=h;
+            uint64_t id=best_[h].load()&noExample_;
+            std::string example("none kept");
+            if(id!=noExample_){
+                uint64_t* g=&(examples_[6*id]);
+                SimplestRegPathIndividual reference(false);
+                reference.TFdosage_[0]=g[0]; reference.TFdosage_[1]=g[1];
+                reference.TFproduct_[0]=g[2]; reference.TFproduct_[1]=g[3];
+                reference.cis_[0]=g[4]; reference.cis_[1]=g[5];
+                example=reference.gtypeString(simSet.bitstringLen_);}
+            outfile<<(double)simSet.Popt_<<tab<<(double)simSet.omega_<<tab<<simSet.bitstringLen_<<tab<<(double)simSet.NtfsatPerAllele_<<tab
+                <<intToHetcode(hc)<<tab<<h<<tab<<(double)w<<tab<<(double)(wBarMax-w)<<tab<<example<<std::endl;
+            }//h
+        outfile.flush();
+        std::stringstream msg;
+        msg<<reached<<" of "<<numHetCodes_<<" het codes reached for Popt="<<simSet.Popt_<<"; "<<numExamples_.load()<<" improvements recorded";
+        logger.Log(logInfo,msg.str());}
+    };//class HetCodeMaxima
+HetCodeMaxima hetCodeMaxima;
+
+
+
+class NearOptimalSolutions{
+    //--near-optimal=K & --near-optimal-band=EPS: the K best distinct solutions for a Popt, or those within EPS of
+    //wBarMax (at most K of them), found in the same sweep. AddSolution() only keeps ties with the maximum, so this
+    //keeps its own min-heap on wBar, with the solutions in fixed slots & hashed by EqualityHash() so a repeat adds to
+    //its items instead of taking a place. the entry bar (the K-th best, or wBarMax-EPS) is published as an atomic
+    //rounded level, so a reference g'type below it is turned away without the lock or building a solution.
+    //a reference g'type with several maxima counts toward each of their rows; the summary table counts only the last
+    public:
+    bool enabled_;
+    unsigned long maxKept_;
+    long double band_;//-one: no band, just the K best
+    std::atomic<uint64_t> threshold_;//rounded wBar in units of 10^-decimalDigitsToRound, +1; 0 admits anything
+    std::mutex mutex_;
+    std::vector<FitnessMaximumSolutionSet> kept_;
+    std::vector<std::pair<long double,int> > heap_;//(wBar, slot in kept_), worst on top
+    std::vector<int> freeSlots_;
+    std::unordered_map<uint64_t,std::vector<int> > index_;//EqualityHash -> slots
+    long double best_;
+    bool bandOverflowed_;
+
+    public:
+    NearOptimalSolutions(void):enabled_(false),maxKept_(0),band_(-one),threshold_(0),best_(-one),bandOverflowed_(false){}
+    ~NearOptimalSolutions(void){}
+
+    public:
+    static uint64_t Level(long double wBar){
+        return (uint64_t)llroundl(MAX(wBar,zero)*powl(ten,(long double)decimalDigitsToRound))+1;}
+
+    bool Admits(long double wBar){
+        return enabled_ && Level(wBar)>=threshold_.load(std::memory_order_relaxed);}
+
+    long double Bound(long double maxPopMeanFitness){//for the phenotype pruning: anything that can reach the bar counts
+        if(!enabled_) return maxPopMeanFitness;
+        uint64_t level=threshold_.load(std::memory_order_relaxed);
+        if(level==0) return -one;
+        return MIN(maxPopMeanFitness,(long double)(level-1)/powl(ten,(long double)decimalDigitsToRound));}
+
+    void Reset(void){//before each Popt
+        std::lock_guard<std::mutex> lock(mutex_);
+        kept_.clear(); heap_.clear(); freeSlots_.clear(); index_.clear();
+        best_=-one;
+        bandOverflowed_=false;
+        threshold_=0;}
+
+    void Add(FitnessMaximumSolutionSet& fmss, long weight){
+        long double w=fmss.wBarMax();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(Level(w)<threshold_.load(std::memory_order_relaxed)) return;//the bar rose since Admits()
+        std::vector<int>& bucket=index_[fmss.EqualityHash()];
+        for(unsigned long b=0;b<bucket.size();++b){
+            if(fmss==kept_[bucket[b]]){
+                kept_[bucket[b]].Increment(weight);
+                return;}
+            }//b
+        if(heap_.size()>=maxKept_){
+            if(w<=heap_.front().first){
+                if(band_>=zero) bandOverflowed_=true;
+                return;}
+            if(band_>=zero) bandOverflowed_=true;
+            Evict();}
+        int slot;
+        if(freeSlots_.size()>0){
+                slot=freeSlots_.back();
+                freeSlots_.pop_back();
+                kept_[slot]=fmss;}
+            else{
+                slot=(int)kept_.size();
+                kept_.push_back(fmss);}
+        kept_[slot].numDuplicates_=weight;
+        index_[fmss.EqualityHash()].push_back(slot);//Evict() may have moved the bucket
+        heap_.push_back(std::make_pair(w,slot));
+        std::push_heap(heap_.begin(),heap_.end(),std::greater<std::pair<long double,int> >());
+        best_=MAX(best_,w);
+        if(band_>=zero){
+            while(heap_.size()>0 && Level(heap_.front().first)<Level(best_-band_)){
+                Evict();}
+            }
+        uint64_t level=0;
+        if(band_>=zero){level=Level(best_-band_);}
+        if(heap_.size()>=maxKept_){level=MAX(level,Level(heap_.front().first));}
+        threshold_=level;
+        }//Add
+
+    void Evict(void){//the worst kept solution; caller holds mutex_
+        std::pop_heap(heap_.begin(),heap_.end(),std::greater<std::pair<long double,int> >());
+        int slot=heap_.back().second;
+        heap_.pop_back();
+        std::vector<int>& bucket=index_[kept_[slot].EqualityHash()];
+        bucket.erase(std::find(bucket.begin(),bucket.end(),slot));
+        freeSlots_.push_back(slot);}
+
+    void PrintHeaderLine(std::ostream& outfile, FitnessMaximaSolutionSets& summariesOfSolutions){
+        outfile<<"rank\twBarMax - wBar\t";
+        summariesOfSolutions.PrintHeaderLine(outfile);}
+
+    void Write(std::ostream& outfile, long double Popt){//after the sweep for a Popt has joined its threads
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<int> slots;
+        for(unsigned long i=0;i<heap_.size();++i){slots.push_back(heap_[i].second);}
+        std::vector<FitnessMaximumSolutionSet>& kept=kept_;
+        std::sort(slots.begin(),slots.end(),[&kept](int a, int b){//best first; the rest only so the order is repeatable
+            if(kept[a].wBarMax_!=kept[b].wBarMax_) return kept[a].wBarMax_>kept[b].wBarMax_;
+            if(kept[a].trueHetCode_!=kept[b].trueHetCode_) return kept[a].trueHetCode_<kept[b].trueHetCode_;
+            if(kept[a].mismatchPattern_!=kept[b].mismatchPattern_) return kept[a].mismatchPattern_<kept[b].mismatchPattern_;
+            return kept[a].firstRefGtype()<kept[b].firstRefGtype();});
+        std::string tab("\t");
+        int rank=0;
+        for(unsigned long i=0;i<slots.size();++i){
+            if(i==0 || kept_[slots[i]].wBarMax_<kept_[slots[i-1]].wBarMax_){rank=(int)i+1;}//ties share a rank
+            outfile<<rank<<tab<<(double)(best_-kept_[slots[i]].wBarMax_)<<tab;
+            kept_[slots[i]].PrintDataLine(outfile);}
+        outfile.flush();
+        std::stringstream msg;
+        msg<<"kept "<<slots.size()<<" near-optimal solution(s) for Popt="<<Popt;
+        if(slots.size()>0){
+            msg<<", wBar "<<kept_[slots.back()].wBarMax_<<" to "<<best_;}
+        logger.Log(logInfo,msg.str());
+        if(bandOverflowed_){
+            logger.Log(logWarning,"more than "+std::to_string(maxKept_)+" solutions fall in the --near-optimal-band for Popt="
+                        +std::to_string((double)Popt)+"; only the best "+std::to_string(maxKept_)+" were kept");}
+        }//Write
+    };//class NearOptimalSolutions
+NearOptimalSolutions nearOptimal;
+
+
+class AllSolutionsRecorder{
+    //--save-all-solutions: every solution at a Popt's wBarMax, with all the reference g'types and fitness landscapes
+    //that give it, goes into a FitnessMaximaBitstringSolutions (main's wBarMaxAllSolutions), which drops anything
+    //below a new maximum. the solution is built outside the lock; only the update is serialized
+    public:
+    bool enabled_;
+    FitnessMaximaBitstringSolutions* target_;
+    std::mutex mutex_;
+
+    public:
+    AllSolutionsRecorder(void):enabled_(false),target_(NULL){}
+    ~AllSolutionsRecorder(void){}
+
+    void Record(SimplestRegPathIndividual& solutionIndiv, SimplestRegPathIndividual& focalIndiv,
+                long double wBar, long double phBar, long double phat, long double qhat, bool pNeutral, bool qNeutral,
+                std::string& hetcode, int bitstringLen,
+                long double pAABB,long double pAABb,long double pAAbb,
+                long double pAaBB,long double pAaBb,long double pAabb,
+                long double paaBB,long double paaBb,long double paabb,
+                long double wAABB,long double wAABb,long double wAAbb,
+                long double wAaBB,long double wAaBb,long double wAabb,
+                long double waaBB,long double waaBb,long double waabb){
+        FitnessMaximumBitstringSolution soln;
+        BitstringGenotypeData referenceData;
+        soln.SetSolution(solutionIndiv,wBar,phBar,phat,qhat,pNeutral,qNeutral,hetcode,bitstringLen);
+        soln.SetFitnessLandscape(wBar,phBar,pAABB,pAABb,pAAbb,pAaBB,pAaBb,pAabb,paaBB,paaBb,paabb,
+                                 wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb);
+        referenceData.CollectData(focalIndiv,bitstringLen);
+        soln.AppendReferenceGenotype(referenceData);
+        std::lock_guard<std::mutex> lock(mutex_);
+        target_->UpdateWithNewSolution(soln);
+        }//Record
+    };//class AllSolutionsRecorder
+AllSolutionsRecorder allSolutions;
+
+
+
+void MaximizeUsingBitstringsWeightedReferenceGtype(SimplestRegPathIndividual* focalIndivP, simulationSettings* simSetP,
         genotypeSettings* gtypeSetP, FitnessMaximumSolutionSet* fmssP, long double maxPopMeanFitness,
-        int* solutionEqualsMaxOrBetterP){
+        int* solutionEqualsMaxOrBetterP, long classWeight){
+    //as MaximizeUsingBitstringsOneReferenceGtype(), for a reference g'type that stands for classWeight of them
+    //(a --mismatch-classes representative); the weight is what it counts for in --near-optimal
 
 //int bitstringLen,
 //            long double NtfsatPerAllele, long double deltaG1dosage, long double deltaG1, long double minExpression,
@@ -3833,13 +5925,16 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
     for(int i=0;i<4;++i){pNeutral[i]=qNeutral[i]=false;}
     wAABB=wAABb=wAAbb=wAaBB=wAaBb=wAabb=waaBB=waaBb=waabb=-one;
     phAABB=phAABb=phAAbb=phAaBB=phAaBb=phAabb=phaaBB=phaaBb=phaabb=-one;
+    threadPhaseProfile.Begin(phenotypePhase);
     focalIndiv.CalculatePhenotype(simSet);
     focalIndiv.CalculateFitness(simSet.Popt_,simSet.omega_);
-    std::string focalGtypeBitstringStr=focalIndiv.gtypeString(simSet.bitstringLen_);
+    GenotypeKey focalGtypeKey=focalIndiv.gtypeKey(simSet.bitstringLen_);
     std::string focalGtypeMismatchStr=focalIndiv.mismatchStringMathematicaFormat();
     //create recombinant genotypes
     int numMaxima=0;
+    threadRunStatistics.referenceGtypes_++;
     if(focalIndiv.IsTFheterozygote() && focalIndiv.IsCisHeterozygote()){//maximize for p & q
+            threadRunStatistics.doubleHets_++;
             indivAaBb=focalIndiv;
             
             indivAABB.TFdosage_[0]=indivAABB.TFdosage_[1]=gtypeSet.dosageVal0_;
@@ -3917,10 +6012,13 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
             waabb=indivaabb.CalculateFitness(Popt,omega);
         
         //maximize for p & q
-        MaximizePopMeanFitnessPandQv2(wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb,popMeanFitness,phat,qhat,pNeutral,qNeutral,numMaxima,focalGtypeBitstringStr);
+        threadPhaseProfile.End(phenotypePhase); threadPhaseProfile.Begin(landscapePhase);
+        MaximizePopMeanFitnessPandQv2(wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb,popMeanFitness,phat,qhat,pNeutral,qNeutral,numMaxima,focalGtypeKey);
         collectMeanPhenotypesPQ(phAABB,phAABb,phAAbb,phAaBB,phAaBb,phAabb,phaaBB,phaaBb,phaabb,phat,qhat,popMeanPhenotypes,numMaxima);
+        threadPhaseProfile.End(landscapePhase);
             }
         else if(focalIndiv.IsTFheterozygote()){//maximize for p
+            threadRunStatistics.tfHets_++;
             indivAaBB=focalIndiv;
             
             indivAABB.TFdosage_[0]=indivAABB.TFdosage_[1]=gtypeSet.dosageVal0_;
@@ -3942,11 +6040,14 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
             wAABB=indivAABB.CalculateFitness(Popt,omega);
             wAaBB=focalIndiv.fitness();
             waaBB=indivaaBB.CalculateFitness(Popt,omega);
+            threadPhaseProfile.End(phenotypePhase); threadPhaseProfile.Begin(landscapePhase);
             MaximizePopMeanFitnessP(wAABB,wAaBB,waaBB,popMeanFitness,phat,pNeutral,numMaxima);
             for(int m=0;m<numMaxima;++m){qhat[m]=one;qNeutral[m]=false;}
             collectMeanPhenotypesP(phAABB,phAaBB,phaaBB,phat,popMeanPhenotypes,numMaxima);
+            threadPhaseProfile.End(landscapePhase);
             }
         else if(focalIndiv.IsCisHeterozygote()){//maximize for q
+            threadRunStatistics.cisHets_++;
             indivAABb = focalIndiv;
             
             indivAABB.TFdosage_[0]=indivAABB.TFdosage_[1]=gtypeSet.dosageVal0_;
@@ -3967,11 +6068,15 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
             wAABB=indivAABB.CalculateFitness(Popt,omega);
             wAABb=focalIndiv.fitness();
             wAAbb=indivAAbb.CalculateFitness(Popt,omega);
+            threadPhaseProfile.End(phenotypePhase); threadPhaseProfile.Begin(landscapePhase);
             MaximizePopMeanFitnessQ(wAABB,wAABb,wAAbb,popMeanFitness,qhat,qNeutral,numMaxima);
             for(int m=0;m<numMaxima;++m){phat[m]=one;pNeutral[m]=false;}
             collectMeanPhenotypesQ(phAABB,phAABb,phAAbb,qhat,popMeanPhenotypes,numMaxima);
+            threadPhaseProfile.End(landscapePhase);
             }
         else{//double homozygote AABB
+            threadRunStatistics.homozygotes_++;
+            threadPhaseProfile.End(phenotypePhase);
             indivAABB=focalIndiv;
             phAABB=focalIndiv.phenotype();
             wAABB=focalIndiv.fitness();
@@ -3982,17 +6087,23 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
             popMeanPhenotypes[0]=focalIndiv.phenotype();
             }
 
+    threadPhaseProfile.Begin(bookkeepingPhase);
     popMeanFitness=MIN(MAX(ROUND(popMeanFitness,decimalDigitsToRound),zero),one);
     for(int m=0;m<numMaxima;++m){
         popMeanPhenotypes[m]=MIN(MAX(ROUND(popMeanPhenotypes[m],decimalDigitsToRound),zero),one);}
 
+    //--het-code-maxima needs every reference's het codes, & --near-optimal the solutions of any reference that gets
+    //past its bar; below the running maximum they're worked out in the tie branch, recorded, & not handed back
+    bool recordingAll=hetCodeMaxima.enabled_ || nearOptimal.enabled_;
+    bool belowMaximum=(popMeanFitness<maxPopMeanFitness && (hetCodeMaxima.enabled_ || nearOptimal.Admits(popMeanFitness)));
+    std::vector<FitnessMaximumSolutionSet> nearOptimalAdded;
     
-    
-    
-    if(popMeanFitness==maxPopMeanFitness){
+    if(popMeanFitness==maxPopMeanFitness || belowMaximum){
+        if(!belowMaximum) threadRunStatistics.ties_++;
 
         for(int m=0;m<numMaxima;++m){
-            if(phat[m]==-one && qhat[m]==-one) break;//reached the end
+            bool reachedEnd=(phat[m]==-one && qhat[m]==-one);//or p & q both neutral, which a new maximum keeps
+            if(reachedEnd && !recordingAll) break;//reached the end
             std::string ht("___"), phatstr, qhatstr;//, ABgtype;
             std::stringstream phatstrSS,qhatstrSS;
             phatstrSS<<phat[m]; qhatstrSS<<qhat[m];
@@ -4092,22 +6203,36 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
             if(!pNeutral[m]){pMostCommon=MAX(phat[m],one-phat[m]);}
             if(!qNeutral[m]){qMostCommon=MAX(qhat[m],one-qhat[m]);}
             solutionIndiv.SetMismatchesUsingBitstrings();
-            std::string solGtype=solutionIndiv.gtypeString(simSet.bitstringLen_);
-            std::string refGtype=focalIndiv.gtypeString(simSet.bitstringLen_);
             std::string mhp = solutionIndiv.mismatchHetType();
             std::string mp = solutionIndiv.mismatchStringMathematicaFormat();
             int hc = codeToInt(ht), mhc = codeToInt(mhp);
+            if(hetCodeMaxima.enabled_){
+                hetCodeMaxima.Record(hc,popMeanFitness,focalIndiv);}
             FitnessMaximumSolutionSet thisSolutionSummary(Popt,omega,simSet.NtfsatPerAllele_,simSet.bitstringLen_,popMeanFitness,
                                                           popMeanPhenotypes[m],pMostCommon,
                                                           qMostCommon,pNeutral[m],qNeutral[m],
-                                                          hc,ht,mhc,mhp,mp,solGtype,refGtype,
+                                                          hc,ht,mhc,mhp,mp,
                                                           splitSinglePoptRun,startingTF0val,endTF0val);
+            thisSolutionSummary.SetFirstGtypes(solutionIndiv,focalIndiv);
+            if(nearOptimal.Admits(popMeanFitness) &&
+               std::find(nearOptimalAdded.begin(),nearOptimalAdded.end(),thisSolutionSummary)==nearOptimalAdded.end()){
+                nearOptimal.Add(thisSolutionSummary,classWeight);//once per reference g'type, e.g. for AABB & aabb maxima
+                nearOptimalAdded.push_back(thisSolutionSummary);}
+            if(reachedEnd || belowMaximum){
+                if(reachedEnd) break;
+                continue;}
+            if(allSolutions.enabled_){
+                allSolutions.Record(solutionIndiv,focalIndiv,popMeanFitness,popMeanPhenotypes[m],phat[m],qhat[m],
+                                    pNeutral[m],qNeutral[m],ht,simSet.bitstringLen_,
+                                    phAABB,phAABb,phAAbb,phAaBB,phAaBb,phAabb,phaaBB,phaaBb,phaabb,
+                                    wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb);}
             fmss=thisSolutionSummary;
             solutionEqualsMaxOrBetter=true;
             }//m
         }//popMeanFitness==maxPopMeanFitness
 
     if(popMeanFitness>maxPopMeanFitness){
+        threadRunStatistics.newMaxima_++;
 //        newBest=true;
         for(int m=0;m<numMaxima;++m){
             SimplestRegPathIndividual solutionIndiv;
@@ -4207,25 +6332,593 @@ void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIn
             if(!pNeutral[m]){pMostCommon=MAX(phat[m],one-phat[m]);}
             if(!qNeutral[m]){qMostCommon=MAX(qhat[m],one-qhat[m]);}
             solutionIndiv.SetMismatchesUsingBitstrings();
-            std::string solGtype=solutionIndiv.gtypeString(simSet.bitstringLen_);
-            std::string refGtype=focalIndiv.gtypeString(simSet.bitstringLen_);
             std::string mhp = solutionIndiv.mismatchHetType();
             std::string mp = solutionIndiv.mismatchStringMathematicaFormat();
             int hc = codeToInt(ht), mhc = codeToInt(mhp);
+            if(hetCodeMaxima.enabled_){
+                hetCodeMaxima.Record(hc,popMeanFitness,focalIndiv);}
             FitnessMaximumSolutionSet thisSolutionSummary(Popt,omega,simSet.NtfsatPerAllele_,simSet.bitstringLen_,popMeanFitness,
                                                           popMeanPhenotypes[m],pMostCommon,
                                                           qMostCommon,pNeutral[m],qNeutral[m],
-                                                          hc,ht,mhc,mhp,mp,solGtype,refGtype,
+                                                          hc,ht,mhc,mhp,mp,
                                                           splitSinglePoptRun,startingTF0val,endTF0val);
+            thisSolutionSummary.SetFirstGtypes(solutionIndiv,focalIndiv);
+            if(nearOptimal.Admits(popMeanFitness) &&
+               std::find(nearOptimalAdded.begin(),nearOptimalAdded.end(),thisSolutionSummary)==nearOptimalAdded.end()){
+                nearOptimal.Add(thisSolutionSummary,classWeight);//once per reference g'type, e.g. for AABB & aabb maxima
+                nearOptimalAdded.push_back(thisSolutionSummary);}
+            if(allSolutions.enabled_){
+                allSolutions.Record(solutionIndiv,focalIndiv,popMeanFitness,popMeanPhenotypes[m],phat[m],qhat[m],
+                                    pNeutral[m],qNeutral[m],ht,simSet.bitstringLen_,
+                                    phAABB,phAABb,phAAbb,phAaBB,phAaBb,phAabb,phaaBB,phaaBb,phaabb,
+                                    wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb);}
             fmss=thisSolutionSummary;
             solutionEqualsMaxOrBetter=true;
             }//m
         }//popMeanFitness>maxPopMeanFitness
+    threadPhaseProfile.End(bookkeepingPhase);
     
+    }//MaximizeUsingBitstringsWeightedReferenceGtype
+
+void MaximizeUsingBitstringsOneReferenceGtype(SimplestRegPathIndividual* focalIndivP, simulationSettings* simSetP,
+        genotypeSettings* gtypeSetP, FitnessMaximumSolutionSet* fmssP, long double maxPopMeanFitness,
+        int* solutionEqualsMaxOrBetterP){
+    MaximizeUsingBitstringsWeightedReferenceGtype(focalIndivP,simSetP,gtypeSetP,fmssP,maxPopMeanFitness,solutionEqualsMaxOrBetterP,1);
     }//MaximizeUsingBitstringsOneReferenceGtype
 
 
 
+class BestFirstOrder{
+    //for --best-first: visit TF dosage alleles whose homozygotes can get closest to Popt first, so the running maximum
+    //is high early. a homozygote's phenotype depends on the dosage allele only through its mismatch count, and
+    //whatever the TF product allele is, some cis allele gives it any TF-cis mismatch count, so the score is
+    //min over j of |phenotype(dosage mismatches k,k; TF-cis mismatches j,j,j,j) - Popt| for each k.
+    //the same genotypes are visited, so wBarMax & the het patterns are the same; which g'type is found first (and
+    //so represents a row, and anchors the grouping of solutions within tol_) can change
+    public:
+    bool enabled_;
+    std::vector<long double> distanceByMismatches_;//[dosage mismatches]
+    
+    public:
+    BestFirstOrder(void):enabled_(false){}
+    ~BestFirstOrder(void){}
+    
+    public:
+    void Prepare(simulationSettings& simSet){
+        int L=simSet.bitstringLen_;
+        distanceByMismatches_.assign(L+1,two);
+        for(int k=0;k<=L;++k){
+            for(int j=0;j<=L;++j){
+                SimplestRegPathIndividual homozygote(false);
+                uint64_t dosage=(((uint64_t)1)<<k)-1, cis=(((uint64_t)1)<<j)-1;//k & j mismatches with the tacit TF & product 0
+                homozygote.SetGenotype(0,0,dosage); homozygote.SetGenotype(0,1,dosage);
+                homozygote.SetGenotype(2,0,cis); homozygote.SetGenotype(2,1,cis);
+                distanceByMismatches_[k]=MIN(distanceByMismatches_[k],ABS(homozygote.CalculatePhenotype(simSet)-simSet.Popt_));}
+            }
+        }//Prepare
+    
+    long double distance(uint64_t dosageVal){
+        uint64_t tacitTF=(uint64_t) 0;
+        return distanceByMismatches_[HammingDistance(tacitTF,dosageVal)];}
+    
+    void Order(std::vector<uint64_t>& dosageVals){//closest first; numeric order among equals
+        std::stable_sort(dosageVals.begin(),dosageVals.end(),[this](uint64_t a, uint64_t b){return distance(a)<distance(b);});}
+    };//class BestFirstOrder
+BestFirstOrder bestFirst;
+
+
+
+class WarmStartBound{
+    //the winning reference genotypes of the last Popt run, re-evaluated under the next Popt before its sweep starts,
+    //so maxPopMeanFitness starts at a wBar that a genotype in the sweep really reaches instead of at -1.
+    //the sweep still finds that genotype (as a tie), so the solutions don't change; the worse ones that used to be
+    //recorded & then thrown away just aren't recorded
+    public:
+    bool enabled_;
+    std::vector<GenotypeKey> previousWinners_;
+    
+    public:
+    WarmStartBound(void):enabled_(true){}
+    ~WarmStartBound(void){}
+    
+    public:
+    void Remember(FitnessMaximaSolutionSets& summariesOfSolutions, long double Popt){
+        previousWinners_.clear();
+        int p=summariesOfSolutions.indexForPopt(Popt);
+        if(p==-1) return;
+        for(unsigned long i=0;i<summariesOfSolutions.uniqueSolutionsByPopt_[p].size();++i){
+            GenotypeKey& ref=summariesOfSolutions.uniqueSolutionsByPopt_[p][i].firstRefKey_;
+            if(ref.packed() && std::find(previousWinners_.begin(),previousWinners_.end(),ref)==previousWinners_.end()){
+                previousWinners_.push_back(ref);}
+            }
+        }//Remember
+    
+    long double Seed(simulationSettings& simSet, uint64_t lowTf0dosage, uint64_t highTf0dosage){
+        //-1 if there's nothing to go on, as before
+        long double bound=-one;
+        if(!enabled_) return bound;
+        for(unsigned long k=0;k<previousWinners_.size();++k){
+            GenotypeKey& ref=previousWinners_[k];
+            if(ref.bitstringLen()!=simSet.bitstringLen_) continue;
+            if(ref.field(0)<lowTf0dosage || ref.field(0)>highTf0dosage) continue;//not in this run's part of the sweep
+            genotypeSettings gtypeSet(ref.field(0),ref.field(2),ref.field(1),ref.field(3),ref.field(4),ref.field(5));
+            SimplestRegPathIndividual focalIndiv(false);
+            focalIndiv.SetGenotype(0,0,gtypeSet.dosageVal0_); focalIndiv.SetGenotype(0,1,gtypeSet.dosageVal1_);
+            focalIndiv.SetGenotype(1,0,gtypeSet.tfVal0_); focalIndiv.SetGenotype(1,1,gtypeSet.tfVal1_);
+            focalIndiv.SetGenotype(2,0,gtypeSet.cisVal0_); focalIndiv.SetGenotype(2,1,gtypeSet.cisVal1_);
+            FitnessMaximumSolutionSet solution(simSet.bitstringLen_,simSet.splitSinglePoptRun_,lowTf0dosage,highTf0dosage);
+            int found=false;
+            MaximizeUsingBitstringsOneReferenceGtype(&focalIndiv,&simSet,&gtypeSet,&solution,-one,&found);
+            if(found){
+                bound=MAX(bound,solution.wBarMax());}
+            }//k
+        return bound;}
+    };//class WarmStartBound
+WarmStartBound warmStart;
+
+
+
+long double EvaluateReferenceGtype(const uint64_t g[6], simulationSettings& simSet, FitnessMaximumSolutionSet& solution,
+                                   long classWeight=1){
+    //wBar at the best p & q for reference genotype g = {dosage0, dosage1, product0, product1, cis0, cis1}, with
+    //the solution left in solution; for callers that pick genotypes themselves rather than sweeping them
+    genotypeSettings gtypeSet(g[0],g[1],g[2],g[3],g[4],g[5]);
+    SimplestRegPathIndividual focalIndiv(false);
+    focalIndiv.TFdosage_[0]=g[0]; focalIndiv.TFdosage_[1]=g[1];
+    focalIndiv.TFproduct_[0]=g[2]; focalIndiv.TFproduct_[1]=g[3];
+    focalIndiv.cis_[0]=g[4]; focalIndiv.cis_[1]=g[5];//not SetGenotype(), which leaves a stale mismatch string
+    solution.Reset();
+    int found=false;
+    MaximizeUsingBitstringsWeightedReferenceGtype(&focalIndiv,&simSet,&gtypeSet,&solution,-one,&found,classWeight);
+    return found ? solution.wBarMax() : -one;
+    }//EvaluateReferenceGtype
+
+
+
+class SearchRecords{
+    //reference g'types one search thread reached at its best wBar, each once whatever its allele order, with the row
+    //of the thread's solution set it was counted in. keyed on the canonical GenotypeKey; bitstrings too long to pack
+    //keep their canonical fields instead
+    public:
+    int bitstringLen_;
+    long double best_;
+    std::unordered_map<GenotypeKey,int,GenotypeKeyHash> rows_;
+    std::map<std::array<uint64_t,6>,int> wideRows_;
+
+    public:
+    SearchRecords(int bitstringLen):bitstringLen_(bitstringLen),best_(-one){}
+    ~SearchRecords(void){}
+
+    public:
+    static std::array<uint64_t,6> Fields(const uint64_t g[6]){//search order (dosages, products, cis) to gtypeString() order
+        std::array<uint64_t,6> f={{g[0],g[2],g[1],g[3],g[4],g[5]}};
+        return f;}
+
+    bool Insert(const uint64_t g[6], int row){//false if the g'type, in either allele order, is already there
+        std::array<uint64_t,6> f=Fields(g);
+        GenotypeKey key(bitstringLen_,f[0],f[1],f[2],f[3],f[4],f[5]);
+        if(key.packed()) return rows_.insert(std::make_pair(key.Canonical(),row)).second;
+        GenotypeKey::CanonicalOrder(f.data());
+        return wideRows_.insert(std::make_pair(f,row)).second;}
+
+    bool Contains(const uint64_t g[6]){
+        std::array<uint64_t,6> f=Fields(g);
+        GenotypeKey key(bitstringLen_,f[0],f[1],f[2],f[3],f[4],f[5]);
+        if(key.packed()) return rows_.count(key.Canonical())>0;
+        GenotypeKey::CanonicalOrder(f.data());
+        return wideRows_.count(f)>0;}
+
+    void Clear(void){
+        rows_.clear(); wideRows_.clear();}
+
+    void Discount(SearchRecords& counted, FitnessMaximaSolutionSets& found){
+        //takes one item off found's row for every g'type already in counted (an earlier thread's), and adds the rest to counted
+        if(found.uniqueSolutionsByPopt_.empty()) return;
+        std::vector<FitnessMaximumSolutionSet>& solutions=found.uniqueSolutionsByPopt_[0];//one Popt per search
+        for(std::unordered_map<GenotypeKey,int,GenotypeKeyHash>::iterator it=rows_.begin();it!=rows_.end();++it){
+            if(!counted.rows_.insert(*it).second) solutions[it->second].Increment(-1);}
+        for(std::map<std::array<uint64_t,6>,int>::iterator it=wideRows_.begin();it!=wideRows_.end();++it){
+            if(!counted.wideRows_.insert(*it).second) solutions[it->second].Increment(-1);}
+        }//Discount
+    };//class SearchRecords
+
+
+
+class HeuristicSearch{
+    //--search: multi-start local search over the six allele bitstrings, for bitstring lengths the enumeration can't
+    //reach (it visits ~2^(6L)/8 reference genotypes). each start is a random reference genotype; it climbs by
+    //single-bit flips (the best neighbour, ties broken at random, with a limited number of sideways steps across
+    //plateaus), then the local maximum is kicked by flipping a few random bits and climbing again.
+    //every genotype evaluated at or above the thread's best wBar goes into its solution set, so the het patterns of
+    //tied optima are collected the same way as in the enumeration; items count the distinct genotypes (either allele
+    //order being the same genotype) any thread reached at the overall best, not all the genotypes that give the solution.
+    //each thread has its own RNG stream (seed + thread number), so a run repeats for a given seed & thread count
+    public:
+    bool enabled_, validating_;
+    int restarts_, kicks_, sidewaysSteps_, bitsPerKick_;
+    uint64_t seed_;
+    int validatedPopts_, recoveredMaxima_, recoveredPatterns_, exhaustivePatterns_;//--validate-search tallies
+    
+    public:
+    HeuristicSearch(void):enabled_(false),validating_(false),restarts_(64),kicks_(20),sidewaysSteps_(20),bitsPerKick_(3),
+                        seed_(20210228),validatedPopts_(0),recoveredMaxima_(0),recoveredPatterns_(0),exhaustivePatterns_(0){}
+    ~HeuristicSearch(void){}
+    
+    public:
+    long double Evaluate(const uint64_t g[6], simulationSettings& simSet, FitnessMaximumSolutionSet& solution){
+        return EvaluateReferenceGtype(g,simSet,solution);}
+    
+    void Record(const uint64_t g[6], long double w, FitnessMaximumSolutionSet& solution,
+                SearchRecords& recorded, FitnessMaximaSolutionSets& found){
+        if(w<zero || w<recorded.best_) return;//no maximum, or not the best
+        if(w>recorded.best_){
+            recorded.best_=w;
+            recorded.Clear();}
+        if(recorded.Contains(g)) return;//already counted
+        recorded.Insert(g,found.AddSolution(solution));}
+    
+    long double Climb(uint64_t g[6], long double w, simulationSettings& simSet, std::mt19937_64& rng,
+                      FitnessMaximumSolutionSet& solution, SearchRecords& recorded, FitnessMaximaSolutionSets& found){
+        int L=simSet.bitstringLen_, sideways=0;
+        while(true){
+            long double bestNeighbour=-one;
+            int bestSite=-1, bestBit=-1, equals=0;
+            for(int site=0;site<6;++site){
+                for(int bit=0;bit<L;++bit){
+                    g[site]^=((uint64_t)1)<<bit;
+                    long double wn=Evaluate(g,simSet,solution);
+                    Record(g,wn,solution,recorded,found);
+                    g[site]^=((uint64_t)1)<<bit;
+                    if(wn>bestNeighbour){
+                            bestNeighbour=wn; bestSite=site; bestBit=bit; equals=1;}
+                        else if(wn==bestNeighbour){//pick uniformly among the equal best
+                            ++equals;
+                            if(rng()%equals==0){bestSite=site; bestBit=bit;}
+                            }
+                    }//bit
+                }//site
+            if(bestSite==-1) return w;
+            if(bestNeighbour>w){
+                    g[bestSite]^=((uint64_t)1)<<bestBit;
+                    w=bestNeighbour;
+                    sideways=0;}
+                else if(bestNeighbour==w && sideways<sidewaysSteps_){
+                    g[bestSite]^=((uint64_t)1)<<bestBit;
+                    ++sideways;}
+                else{
+                    return w;}
+            }
+        }//Climb
+    
+    void SearchThread(simulationSettings* simSetP, int thread, int numRestarts, FitnessMaximaSolutionSets* foundP,
+                      SearchRecords* recordedP){
+        simulationSettings simSet=*simSetP;
+        FitnessMaximaSolutionSets& found=*foundP;
+        SearchRecords& recorded=*recordedP;//genotypes already in found at the thread's best wBar
+        std::mt19937_64 rng(seed_+(uint64_t)thread*0x9e3779b97f4a7c15ULL);
+        int L=simSet.bitstringLen_;
+        uint64_t mask=(((uint64_t)1)<<L)-1;
+        FitnessMaximumSolutionSet solution(L,simSet.splitSinglePoptRun_,simSet.startingTF0val_,simSet.endTF0val_);
+        for(int r=0;r<numRestarts;++r){
+            uint64_t g[6];
+            for(int site=0;site<6;++site){g[site]=rng()&mask;}
+            long double w=Evaluate(g,simSet,solution);
+            Record(g,w,solution,recorded,found);
+            w=Climb(g,w,simSet,rng,solution,recorded,found);
+            for(int k=0;k<kicks_;++k){
+                uint64_t kicked[6];
+                for(int site=0;site<6;++site){kicked[site]=g[site];}
+                for(int b=0;b<bitsPerKick_;++b){
+                    kicked[rng()%6]^=((uint64_t)1)<<(rng()%L);}
+                long double wk=Evaluate(kicked,simSet,solution);
+                Record(kicked,wk,solution,recorded,found);
+                wk=Climb(kicked,wk,simSet,rng,solution,recorded,found);
+                if(wk>=w){
+                    for(int site=0;site<6;++site){g[site]=kicked[site];}
+                    w=wk;}
+                }//k
+            }//r
+        }//SearchThread
+    
+    void Search(simulationSettings& simSet, FitnessMaximaSolutionSets& summariesOfSolutions){
+        int availableThreads = MAX((unsigned int)1,std::thread::hardware_concurrency());
+        int threadsToUse = MIN(MIN(availableThreads,16),MAX(1,restarts_));
+        std::vector<FitnessMaximaSolutionSets> found(threadsToUse,FitnessMaximaSolutionSets(simSet.splitSinglePoptRun_,
+                                                        simSet.startingTF0val_,simSet.endTF0val_));
+        std::vector<SearchRecords> recorded(threadsToUse,SearchRecords(simSet.bitstringLen_));
+        std::vector<std::thread> threadList;
+        for(int t=0;t<threadsToUse;++t){
+            int numRestarts=restarts_/threadsToUse + ((t<restarts_%threadsToUse) ? 1 : 0);
+            threadList.push_back(std::thread(&HeuristicSearch::SearchThread,this,&simSet,t,numRestarts,&(found[t]),&(recorded[t])));}
+        long double best=-one;
+        for(unsigned long t=0;t<threadList.size();++t){
+            threadList[t].join();
+            best=MAX(best,recorded[t].best_);}
+        SearchRecords counted(simSet.bitstringLen_);//g'types already counted at the overall best, in thread order
+        for(unsigned long t=0;t<threadList.size();++t){
+            if(recorded[t].best_==best) recorded[t].Discount(counted,found[t]);
+            summariesOfSolutions.ConcatenateSolutions(found[t]);}
+        }//Search
+    
+    std::vector<std::string> HetPatterns(FitnessMaximaSolutionSets& solutions, long double Popt){
+        std::vector<std::string> patterns;
+        int p=solutions.indexForPopt(Popt);
+        if(p==-1) return patterns;
+        for(unsigned long i=0;i<solutions.uniqueSolutionsByPopt_[p].size();++i){
+            patterns.push_back(solutions.uniqueSolutionsByPopt_[p][i].trueHetPattern_);}
+        std::sort(patterns.begin(),patterns.end());
+        patterns.erase(std::unique(patterns.begin(),patterns.end()),patterns.end());
+        return patterns;}
+    
+    std::string Validate(FitnessMaximaSolutionSets& exhaustive, FitnessMaximaSolutionSets& searched, long double Popt){
+        //compares the search's maximum & het patterns with the enumeration's for one Popt; returns a line for the log
+        long double wExhaustive=exhaustive.wBarMax(Popt), wSearched=searched.wBarMax(Popt);
+        bool maxFound=(ABS(wExhaustive-wSearched)<=FitnessMaximumSolutionSet::tol_);
+        std::vector<std::string> wanted=HetPatterns(exhaustive,Popt), got=HetPatterns(searched,Popt);
+        int patternsFound=0;
+        if(maxFound){
+            for(unsigned long i=0;i<wanted.size();++i){
+                if(std::binary_search(got.begin(),got.end(),wanted[i])) ++patternsFound;}
+            }
+        ++validatedPopts_;
+        if(maxFound) ++recoveredMaxima_;
+        recoveredPatterns_+=patternsFound; exhaustivePatterns_+=(int)wanted.size();
+        std::stringstream line;
+        line<<"search check Popt="<<Popt<<": wBarMax "<<wExhaustive<<" (enumeration) vs "<<wSearched<<" (search), "
+            <<patternsFound<<" of "<<wanted.size()<<" het patterns"<<(maxFound ? "" : "  MISSED");
+        return line.str();}
+    
+    std::string ValidationSummary(void){
+        std::stringstream line;
+        line<<"search found the maximum at "<<recoveredMaxima_<<" of "<<validatedPopts_<<" Popts, and "
+            <<recoveredPatterns_<<" of "<<exhaustivePatterns_<<" het patterns";
+        return line.str();}
+    };//class HeuristicSearch
+HeuristicSearch heuristicSearch;
+
+
+
+class PrevalenceSampler{
+    //--sample=N: estimates, for each het code, the fraction of all reference genotypes whose best p & q give it,
+    //from N reference genotypes drawn uniformly (all six bitstrings at random). nothing is kept per sample, so N
+    //can run to billions; the threads take chunks of samples & add their tallies to shared atomic counts.
+    //each chunk has its own RNG stream (seed + chunk number), so the counts for a seed don't depend on the threads.
+    //every reportEvery_ samples the counts so far go to the log & the prevalence file, with 95% Wilson intervals
+    public:
+    static const int numHetCodes_=27;//see codeToInt(); counts_[numHetCodes_] is for g'types with no maximum found
+    static const uint64_t chunkSize_=4096;
+    bool enabled_;
+    uint64_t samples_, reportEvery_, seed_;
+    std::atomic<uint64_t> counts_[numHetCodes_+1];
+    std::atomic<uint64_t> nextChunk_;
+    uint64_t nextReport_;
+    std::mutex reportMutex_;
+    std::ostream* prevalenceFile_;
+    long double Popt_, omega_, Ntf_;
+    int bitstringLen_;
+    
+    public:
+    PrevalenceSampler(void):enabled_(false),samples_(0),reportEvery_(0),seed_(20210228),nextChunk_(0),nextReport_(0),
+                            prevalenceFile_(NULL),Popt_(-one),omega_(-one),Ntf_(-one),bitstringLen_(0){
+        for(int h=0;h<=numHetCodes_;++h){counts_[h]=0;}
+        }
+    ~PrevalenceSampler(void){}
+    
+    public:
+    static void WilsonInterval(uint64_t count, uint64_t n, long double& low, long double& high){
+        const long double z=1.959963984540054L;
+        if(n==0){low=zero; high=one; return;}
+        long double p=(long double)count/(long double)n, z2n=z*z/(long double)n;
+        long double centre=(p+half*z2n)/(one+z2n);
+        long double halfWidth=z*sqrtl(p*(one-p)/(long double)n+z2n/(four*(long double)n))/(one+z2n);
+        low=MAX(zero,centre-halfWidth); high=MIN(one,centre+halfWidth);}
+    
+    void PrintHeaderLine(std::ostream& outfile){
+        outfile<<"Popt\tomega\tbitstringLen\tNtf\tsamples\thet pattern\thet code\tcount\tfraction\tCI low\tCI high"<<std::endl;}
+    
+    void Report(bool final){//caller holds reportMutex_
+        uint64_t counts[numHetCodes_+1], n=0;
+        for(int h=0;h<=numHetCodes_;++h){
+            counts[h]=counts_[h].load(std::memory_order_relaxed);
+            n+=counts[h];}//a consistent total, even though other threads are still adding
+        std::string tab("\t");
+        std::stringstream msg;
+        msg<<(final ? "sampled " : "sampled so far ")<<n<<" of "<<samples_<<" reference g'types for Popt="<<Popt_<<":";
+        for(int h=0;h<=numHetCodes_;++h){
+            if(counts[h]==0) continue;
+            int hc=h;
+            long double low,high;
+            WilsonInterval(counts[h],n,low,high);
+            std::string pattern=(h<numHetCodes_) ? intToHetcode(hc) : "none";
+            msg<<" "<<pattern<<" "<<(double)counts[h]/(double)n<<" ["<<(double)low<<","<<(double)high<<"]";
+            if(prevalenceFile_!=NULL){
+                (*prevalenceFile_)<<(double)Popt_<<tab<<(double)omega_<<tab<<bitstringLen_<<tab<<(double)Ntf_<<tab<<n<<tab
+                    <<pattern<<tab<<((h<numHetCodes_) ? h : -1)<<tab<<counts[h]<<tab<<(double)counts[h]/(double)n<<tab<<(double)low<<tab<<(double)high<<std::endl;}
+            }//h
+        logger.Log(logInfo,msg.str());}
+    
+    void SampleThread(simulationSettings* simSetP, FitnessMaximaSolutionSets* bestP){
+        simulationSettings simSet=*simSetP;
+        int L=simSet.bitstringLen_;
+        uint64_t mask=(L>=64) ? ~((uint64_t)0) : (((uint64_t)1)<<L)-1;
+        uint64_t numChunks=(samples_+chunkSize_-1)/chunkSize_;
+        long double best=-one;
+        FitnessMaximumSolutionSet solution(L,simSet.splitSinglePoptRun_,simSet.startingTF0val_,simSet.endTF0val_);
+        for(uint64_t chunk=nextChunk_++;chunk<numChunks;chunk=nextChunk_++){
+            std::mt19937_64 rng(seed_+chunk*0x9e3779b97f4a7c15ULL);
+            uint64_t counts[numHetCodes_+1]={0}, n=MIN(chunkSize_,samples_-chunk*chunkSize_);
+            for(uint64_t i=0;i<n;++i){
+                uint64_t g[6];
+                for(int site=0;site<6;++site){g[site]=rng()&mask;}
+                long double w=EvaluateReferenceGtype(g,simSet,solution);
+                if(w>=zero && solution.trueHetCode_>=0 && solution.trueHetCode_<numHetCodes_){
+                        counts[solution.trueHetCode_]++;}
+                    else{
+                        counts[numHetCodes_]++;}
+                if(w>=zero && w>=best){//keep the best genotypes sampled for the summary table
+                    best=w;
+                    bestP->AddSolution(solution);}
+                }//i
+            uint64_t done=0;
+            for(int h=0;h<=numHetCodes_;++h){
+                done+=counts_[h].fetch_add(counts[h],std::memory_order_relaxed)+counts[h];}
+            if(reportEvery_>0 && done<samples_){
+                std::lock_guard<std::mutex> lock(reportMutex_);
+                if(done>=nextReport_){
+                    Report(false);
+                    while(nextReport_<=done){nextReport_+=reportEvery_;}
+                    }
+                }
+            }//chunk
+        }//SampleThread
+    
+    void Sample(simulationSettings& simSet, FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream* prevalenceFile){
+        for(int h=0;h<=numHetCodes_;++h){counts_[h]=0;}
+        nextChunk_=0;
+        nextReport_=reportEvery_;
+        prevalenceFile_=prevalenceFile;
+        Popt_=simSet.Popt_; omega_=simSet.omega_; Ntf_=simSet.NtfsatPerAllele_; bitstringLen_=simSet.bitstringLen_;
+        int threadsToUse = MAX((unsigned int)1,std::thread::hardware_concurrency());
+        std::vector<FitnessMaximaSolutionSets> best(threadsToUse,FitnessMaximaSolutionSets(simSet.splitSinglePoptRun_,
+                                                        simSet.startingTF0val_,simSet.endTF0val_));
+        std::vector<std::thread> threadList;
+        for(int t=0;t<threadsToUse;++t){
+            threadList.push_back(std::thread(&PrevalenceSampler::SampleThread,this,&simSet,&(best[t])));}
+        for(unsigned long t=0;t<threadList.size();++t){
+            threadList[t].join();
+            summariesOfSolutions.ConcatenateSolutions(best[t]);}
+        Report(true);
+        if(prevalenceFile_!=NULL){prevalenceFile_->flush();}
+        }//Sample
+    };//class PrevalenceSampler
+PrevalenceSampler prevalenceSampler;
+
+
+
+class MismatchClass{//reference g'types with the same solution; see MismatchClasses
+    public:
+    uint64_t count_;//#g'types in the sweep's loop space
+    uint64_t g_[6];//one of them, {dosage0, dosage1, product0, product1, cis0, cis1}; only the fields for its part are set
+    };//MismatchClass
+
+class MismatchClasses{
+    //--mismatch-classes: a reference g'type's solution depends only on its 6 mismatch counts (dosage 0 & 1 against the
+    //tacit TF, and each TF product allele against each cis allele) and on which of the dosage, product & cis sites
+    //have different alleles. so the sweep's loop space (dosageVal1<=dosageVal0, tfVal1<=tfVal0, cisVal1<=cisVal0, or
+    //any dosageVal1 when splitting a Popt) splits into classes that are maximized once each, with the class size
+    //going into the items column, instead of visiting every g'type.
+    //dosage pairs are few enough to count one by one. the product & cis quadruples are counted a bit at a time from
+    //the top bit: the state is the 4 TF-cis mismatch counts so far and whether tfVal1<tfVal0 & cisVal1<cisVal0 are
+    //already settled by a higher bit, which is O(16 L^5) work rather than 2^(4L)
+    public:
+    bool enabled_;
+    int bitstringLen_;
+    bool splitSinglePoptRun_;
+    uint64_t lowTf0_, highTf0_;
+    std::vector<MismatchClass> dosageClasses_, siteClasses_;//dosage pairs; product & cis quadruples
+    
+    public:
+    MismatchClasses(void):enabled_(false),bitstringLen_(0),splitSinglePoptRun_(false),lowTf0_(0),highTf0_(0){}
+    ~MismatchClasses(void){}
+    
+    public:
+    void BuildDosageClasses(void){
+        int L=bitstringLen_;
+        uint64_t maxBitstringVal=((uint64_t)1)<<L;
+        uint64_t tacitTF=(uint64_t) 0;
+        std::vector<MismatchClass> byKey((L+1)*(L+1)*2);//[dosage0 mismatches][dosage1 mismatches][dosages differ]
+        for(unsigned long k=0;k<byKey.size();++k){byKey[k].count_=0;}
+        for(uint64_t dosageVal0=lowTf0_;dosageVal0<=highTf0_;++dosageVal0){
+            uint64_t highDosageVal1=(splitSinglePoptRun_) ? maxBitstringVal-1 : dosageVal0;
+            for(uint64_t dosageVal1=0;dosageVal1<=highDosageVal1;++dosageVal1){
+                MismatchClass& c=byKey[(HammingDistance(tacitTF,dosageVal0)*(L+1)+HammingDistance(tacitTF,dosageVal1))*2
+                                        +(dosageVal0!=dosageVal1)];
+                if(c.count_++==0){
+                    c.g_[0]=dosageVal0; c.g_[1]=dosageVal1;}
+                }//dosageVal1
+            }//dosageVal0
+        dosageClasses_.clear();
+        for(unsigned long k=0;k<byKey.size();++k){
+            if(byKey[k].count_>0) dosageClasses_.push_back(byKey[k]);}
+        }//BuildDosageClasses
+    
+    void BuildSiteClasses(void){
+        int L=bitstringLen_, n=L+1;
+        unsigned long numStates=(unsigned long)n*n*n*n*4;//[t0c0][t0c1][t1c0][t1c1][tfVal1<tfVal0][cisVal1<cisVal0]
+        std::vector<MismatchClass> states(numStates), next(numStates);
+        for(unsigned long k=0;k<numStates;++k){states[k].count_=0;}
+        for(int i=0;i<6;++i){states[0].g_[i]=0;}
+        states[0].count_=1;//no bits yet: all mismatches 0, both pairs still equal
+        for(int bit=0;bit<L;++bit){//from the top bit down
+            for(unsigned long k=0;k<numStates;++k){next[k].count_=0;}
+            for(unsigned long k=0;k<numStates;++k){
+                if(states[k].count_==0) continue;
+                bool tLess=(k>>1)&1, cLess=k&1;
+                unsigned long h=k>>2;
+                int h11=h%n, h10=(h/n)%n, h01=(h/(n*n))%n, h00=(int)(h/(n*n*n));
+                for(int b=0;b<16;++b){
+                    int t0=(b>>3)&1, t1=(b>>2)&1, c0=(b>>1)&1, c1=b&1;
+                    if((!tLess && t1>t0) || (!cLess && c1>c0)) continue;//outside the loop space
+                    unsigned long nk=((((unsigned long)(h00+(t0^c0))*n+h01+(t0^c1))*n+h10+(t1^c0))*n+h11+(t1^c1))*4
+                                        +(tLess || t1<t0)*2+(cLess || c1<c0);
+                    MismatchClass& c=next[nk];
+                    if(c.count_==0){
+                        c.g_[2]=(states[k].g_[2]<<1)|t0; c.g_[3]=(states[k].g_[3]<<1)|t1;
+                        c.g_[4]=(states[k].g_[4]<<1)|c0; c.g_[5]=(states[k].g_[5]<<1)|c1;}
+                    c.count_+=states[k].count_;
+                    }//b
+                }//k
+            states.swap(next);
+            }//bit
+        siteClasses_.clear();
+        for(unsigned long k=0;k<numStates;++k){
+            if(states[k].count_>0) siteClasses_.push_back(states[k]);}
+        }//BuildSiteClasses
+    
+    void Build(int bitstringLen, bool splitSinglePoptRun, uint64_t lowTf0, uint64_t highTf0){//only if something changed
+        if(dosageClasses_.size()>0 && bitstringLen==bitstringLen_ && splitSinglePoptRun==splitSinglePoptRun_
+           && lowTf0==lowTf0_ && highTf0==highTf0_) return;
+        bitstringLen_=bitstringLen; splitSinglePoptRun_=splitSinglePoptRun; lowTf0_=lowTf0; highTf0_=highTf0;
+        BuildDosageClasses();
+        BuildSiteClasses();
+        std::stringstream msg;
+        msg<<dosageClasses_.size()<<" dosage classes x "<<siteClasses_.size()<<" TF-cis classes";
+        logger.Log(logInfo,msg.str());}
+    
+    static long ClassSize(MismatchClass& dc, MismatchClass& sc, bool& clamped){//dc.count_*sc.count_, or LONG_MAX if that's too big
+        clamped=(dc.count_>0 && sc.count_>(uint64_t)LONG_MAX/dc.count_);
+        return clamped ? LONG_MAX : (long)(dc.count_*sc.count_);}
+    
+    void MaximizeThread(simulationSettings* simSetP, int thread, int numThreads, FitnessMaximaSolutionSets* foundP){
+        simulationSettings simSet=*simSetP;
+        FitnessMaximaSolutionSets& found=*foundP;
+        FitnessMaximumSolutionSet solution(simSet.bitstringLen_,simSet.splitSinglePoptRun_,simSet.startingTF0val_,simSet.endTF0val_);
+        long double best=-one;
+        uint64_t numClasses=(uint64_t)dosageClasses_.size()*siteClasses_.size();
+        for(uint64_t i=thread;i<numClasses;i+=numThreads){
+            MismatchClass& dc=dosageClasses_[i/siteClasses_.size()];
+            MismatchClass& sc=siteClasses_[i%siteClasses_.size()];
+            uint64_t g[6]={dc.g_[0],dc.g_[1],sc.g_[2],sc.g_[3],sc.g_[4],sc.g_[5]};
+            if(phenotypeIndex.enabled_ && !phenotypeIndex.ReferenceCanReach(genotypeSettings(g[0],g[1],g[2],g[3],g[4],g[5]),
+                                                                            simSet.Popt_,simSet.omega_,nearOptimal.Bound(best))){
+                threadRunStatistics.prunedGtypes_++;
+                continue;}
+            bool clamped;
+            long count=ClassSize(dc,sc,clamped);
+            long double w=EvaluateReferenceGtype(g,simSet,solution,count);//the representative stands for the whole class
+            if(w<zero || w<best) continue;
+            best=w;
+            if(clamped){
+                logger.Log(logWarning,"a mismatch class is too big for the items column");}
+            solution.numDuplicates_=count;
+            found.AddSolution(solution);
+            }//i
+        }//MaximizeThread
+    };//class MismatchClasses
+MismatchClasses mismatchClasses;
+
+
+
 
 void MaximizeUsingBitstringsDosageOnly(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage,
                 long double deltaG1, long double minExpression, long double maxExpression,
@@ -4234,7 +6927,8 @@ void MaximizeUsingBitstringsDosageOnly(int bitstringLen, long double NtfsatPerAl
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries){
     //this version considers only the dosage site
     //each allele 2 variant runs in its own thread
-    coutLock.lock(); std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega<<std::endl; coutLock.unlock();
+    std::stringstream msg; msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
     
     simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
@@ -4289,13 +6983,15 @@ void MaximizeUsingBitstringsDosageOnly(int bitstringLen, long double NtfsatPerAl
                         genotypeSettings *gset = &(gtypeSettingsList[t]);
                         simulationSettings *simset = &(simSettingsList[t]);
                         int *sameOrBetter = &(solutionSameOrBetterTF[t]);
-                        std::thread th(
+                        std::thread th=TracedThread(t+1,"MaximizeUsingBitstringsOneReferenceGtype",
                             MaximizeUsingBitstringsOneReferenceGtype,fIndiv,simset,gset,fmss,
                                             maxPopMeanFitness,sameOrBetter);
                         threadList.push_back(move(th));
                         }//t
+                    TraceSpan joinSpan(0,"join barrier",(int)threadList.size());
                     for(int t=0;t<threadList.size();++t){//synchronize threads
                         threadList[t].join();}
+                    joinSpan.End();
                     for(int t=0;t<threadList.size();++t){//collect data
                         if(solutionSameOrBetterTF[t]){
                             summariesOfSolutions.AddSolution(newSolutionSummaries[t]);
@@ -4305,7 +7001,7 @@ void MaximizeUsingBitstringsDosageOnly(int bitstringLen, long double NtfsatPerAl
                     }//make & use threads
             }//while dosageVal1counter
         }//dosageVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
     }//MaximizeUsingBitstringsDosageOnly
 
@@ -4317,7 +7013,8 @@ void MaximizeUsingBitstringsTFproductOnly(int bitstringLen, long double NtfsatPe
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries){
     //this version considers only the dosage site
     //each allele 2 variant runs in its own thread
-    coutLock.lock(); std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega<<std::endl; coutLock.unlock();
+    std::stringstream msg; msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
     
     simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
@@ -4372,13 +7069,15 @@ void MaximizeUsingBitstringsTFproductOnly(int bitstringLen, long double NtfsatPe
                         genotypeSettings *gset = &(gtypeSettingsList[t]);
                         simulationSettings *simset = &(simSettingsList[t]);
                         int *sameOrBetter = &(solutionSameOrBetterTF[t]);
-                        std::thread th(
+                        std::thread th=TracedThread(t+1,"MaximizeUsingBitstringsOneReferenceGtype",
                             MaximizeUsingBitstringsOneReferenceGtype,fIndiv,simset,gset,fmss,
                                             maxPopMeanFitness,sameOrBetter);
                         threadList.push_back(move(th));
                         }//t
+                    TraceSpan joinSpan(0,"join barrier",(int)threadList.size());
                     for(int t=0;t<threadList.size();++t){//synchronize threads
                         threadList[t].join();}
+                    joinSpan.End();
                     for(int t=0;t<threadList.size();++t){//collect data
                         if(solutionSameOrBetterTF[t]){
                             summariesOfSolutions.AddSolution(newSolutionSummaries[t]);
@@ -4388,7 +7087,7 @@ void MaximizeUsingBitstringsTFproductOnly(int bitstringLen, long double NtfsatPe
                     }//make & use threads
             }//while tfVal1counter
         }//tfVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
     }//MaximizeUsingBitstringsTFproductOnly
 
@@ -4401,7 +7100,8 @@ void MaximizeUsingBitstringsCisOnly(int bitstringLen, long double NtfsatPerAllel
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries){
     //this version considers only the cis site
     //each allele 2 variant runs in its own thread
-    coutLock.lock(); std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega<<std::endl; coutLock.unlock();
+    std::stringstream msg; msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
     
     simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
@@ -4456,13 +7156,15 @@ void MaximizeUsingBitstringsCisOnly(int bitstringLen, long double NtfsatPerAllel
                         genotypeSettings *gset = &(gtypeSettingsList[t]);
                         simulationSettings *simset = &(simSettingsList[t]);
                         int *sameOrBetter = &(solutionSameOrBetterTF[t]);
-                        std::thread th(
+                        std::thread th=TracedThread(t+1,"MaximizeUsingBitstringsOneReferenceGtype",
                             MaximizeUsingBitstringsOneReferenceGtype,fIndiv,simset,gset,fmss,
                                             maxPopMeanFitness,sameOrBetter);
                         threadList.push_back(move(th));
                         }//t
+                    TraceSpan joinSpan(0,"join barrier",(int)threadList.size());
                     for(int t=0;t<threadList.size();++t){//synchronize threads
                         threadList[t].join();}
+                    joinSpan.End();
                     for(int t=0;t<threadList.size();++t){//collect data
                         if(solutionSameOrBetterTF[t]){
                             summariesOfSolutions.AddSolution(newSolutionSummaries[t]);
@@ -4472,7 +7174,7 @@ void MaximizeUsingBitstringsCisOnly(int bitstringLen, long double NtfsatPerAllel
                     }//make & use threads
             }//while cisVal1counter
         }//cisVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
     }//MaximizeUsingBitstringsCisOnly
 
@@ -4520,7 +7222,8 @@ void MaximizeUsingBitstringsTFOnly(int bitstringLen, long double NtfsatPerAllele
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries){
     //this version holds the cis locus constant, maximizing over variation in the TF genotype
     //each allele 2 variant runs in its own thread
-    coutLock.lock(); std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega<<std::endl; coutLock.unlock();
+    std::stringstream msg; msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
     
     simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
@@ -4577,13 +7280,15 @@ void MaximizeUsingBitstringsTFOnly(int bitstringLen, long double NtfsatPerAllele
                             genotypeSettings *gset = &(gtypeSettingsList[t]);
                             simulationSettings *simset = &(simSettingsList[t]);
                             int *sameOrBetter = &(solutionSameOrBetterTF[t]);
-                            std::thread th(
+                            std::thread th=TracedThread(t+1,"MaximizeUsingBitstringsAllTF1Gtypes",
                                 MaximizeUsingBitstringsAllTF1Gtypes,fIndiv,simset,gset,fmss,
                                                 maxPopMeanFitness,sameOrBetter);
                             threadList.push_back(move(th));
                             }//t
+                        TraceSpan joinSpan(0,"join barrier",(int)threadList.size());
                         for(int t=0;t<threadList.size();++t){//synchronize threads
                             threadList[t].join();}
+                        joinSpan.End();
                         for(int t=0;t<threadList.size();++t){//collect data
                             if(solutionSameOrBetterTF[t]){
                                 summariesOfSolutions.ConcatenateSolutions(newSolutionSummarySets[t]);
@@ -4594,7 +7299,7 @@ void MaximizeUsingBitstringsTFOnly(int bitstringLen, long double NtfsatPerAllele
                 }//while dosageVal1counter
             }//tfVal0
         }//dosageVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
     }//MaximizeUsingBitstringsTFOnly
 
@@ -4622,6 +7327,10 @@ void MaximizeUsingBitstringsAllCisGtypes(SimplestRegPathIndividual* focalIndivP,
         for(uint64_t cisVal1=0;cisVal1<=cisVal0;++cisVal1){//2nd cis allele promoter
             focalIndiv.SetGenotype(2,1,cisVal1);
             gtypeSet.cisVal1_=cisVal1;
+            if(phenotypeIndex.enabled_ && !phenotypeIndex.ReferenceCanReach(gtypeSet,simSet.Popt_,simSet.omega_,
+                                                                            nearOptimal.Bound(maxPopMeanFitness))){
+                threadRunStatistics.prunedGtypes_++;
+                continue;}
             solutionEqualsMaxOrBetter=false;
             newSolutionSummary.Reset();
             MaximizeUsingBitstringsOneReferenceGtype(&focalIndiv,&simSet,&gtypeSet,&newSolutionSummary,
@@ -4643,7 +7352,8 @@ void MaximizeUsingBitstringsThreadable(int bitstringLen, long double NtfsatPerAl
                 long double Popt, long double omega,
                 FitnessMaximaBitstringSolutions& wBarMaxAllSolutions, std::ostream& outputfileAllSolutions, bool saveAllSolutions,
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries){
-    coutLock.lock(); std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega<<std::endl; coutLock.unlock();
+    std::stringstream msg; msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
     
     simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
@@ -4713,13 +7423,15 @@ void MaximizeUsingBitstringsThreadable(int bitstringLen, long double NtfsatPerAl
                                             genotypeSettings *gset = &(gtypeSettingsList[t]);
                                             simulationSettings *simset = &(simSettingsList[t]);
                                             int *sameOrBetter = &(solutionSameOrBetterTF[t]);
-                                            std::thread th(
+                                            std::thread th=TracedThread(t+1,"MaximizeUsingBitstringsOneReferenceGtype",
                                                 MaximizeUsingBitstringsOneReferenceGtype,fIndiv,simset,gset,fmss,
                                                                 maxPopMeanFitness,sameOrBetter);
                                             threadList.push_back(move(th));
                                             }//t
+                                        TraceSpan joinSpan(0,"join barrier",(int)threadList.size());
                                         for(int t=0;t<threadList.size();++t){//synchronize threads
                                             threadList[t].join();}
+                                        joinSpan.End();
                                         for(int t=0;t<threadList.size();++t){//collect data
                                             if(solutionSameOrBetterTF[t]){
                                                 summariesOfSolutions.AddSolution(newSolutionSummaries[t]);
@@ -4737,7 +7449,7 @@ void MaximizeUsingBitstringsThreadable(int bitstringLen, long double NtfsatPerAl
                 }//dosageVal1
             }//tfVal0
         }//dosageVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
     }//maximizeUsingBitstringsThreadable
 
@@ -4749,28 +7461,40 @@ void MaximizeUsingBitstringsThreadableAllCis(int bitstringLen, long double Ntfsa
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries,
                 bool splitSinglePoptRun, uint64_t lowTf0dosage, uint64_t highTf0dosage){
     //this version puts the whole cis array into one thread
-    coutLock.lock();
-    std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    std::stringstream msg;
+    msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
     if(splitSinglePoptRun){
-        std::cout<<" for tf0 dosage "<<lowTf0dosage;
+        msg<<" for tf0 dosage "<<lowTf0dosage;
         if(highTf0dosage>lowTf0dosage){
-            std::cout<<" to "<<highTf0dosage;}
+            msg<<" to "<<highTf0dosage;}
         }
-    std::cout<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
      if(!splitSinglePoptRun){//to eliminate any ambiguity
         lowTf0dosage=0; highTf0dosage=maxBitstringVal-1;}
+    sweepProgress.Start(Popt,maxBitstringVal,splitSinglePoptRun,lowTf0dosage,highTf0dosage);
    
     simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega,
             splitSinglePoptRun,lowTf0dosage,highTf0dosage);
     genotypeSettings gtypeSet;
     SimplestRegPathIndividual focalIndiv(false);//indivAaBb
-    long double maxPopMeanFitness=-one;
+    long double maxPopMeanFitness=warmStart.Seed(simSet,lowTf0dosage,highTf0dosage);//-one without a previous Popt
+    if(maxPopMeanFitness>-one){
+        logger.Log(logDebug,"starting from wBar="+std::to_string((double)maxPopMeanFitness)+", from the last Popt's solutions");}
+    if(phenotypeIndex.enabled_){
+        phenotypeIndex.Prepare(Popt);}
 //    std::vector<long double> phat(10,-one), qhat(10,-one),popMeanPhenotypes(10,-one);
 //    std::vector<bool> pNeutral(4,false), qNeutral(4,false);
     
+    std::vector<uint64_t> dosageVal0s;//the order they're visited in
+    for(uint64_t dosageVal0=lowTf0dosage;dosageVal0<=highTf0dosage;++dosageVal0){
+        dosageVal0s.push_back(dosageVal0);}
+    if(bestFirst.enabled_){
+        bestFirst.Prepare(simSet);
+        bestFirst.Order(dosageVal0s);}
 //    for(uint64_t dosageVal0=0;dosageVal0<maxBitstringVal;++dosageVal0){//1st TF allele dosage  //dosageVal0=3
-    for(uint64_t dosageVal0=lowTf0dosage;dosageVal0<=highTf0dosage;++dosageVal0){//1st TF allele dosage
+    for(unsigned long d0=0;d0<dosageVal0s.size();++d0){//1st TF allele dosage
+        uint64_t dosageVal0=dosageVal0s[d0];
         gtypeSet.dosageVal0_=dosageVal0;
         focalIndiv.SetGenotype(0,0,dosageVal0);
         for(uint64_t tfVal0=0;tfVal0<maxBitstringVal;++tfVal0){//1st TF allele product
@@ -4779,8 +7503,18 @@ void MaximizeUsingBitstringsThreadableAllCis(int bitstringLen, long double Ntfsa
             uint64_t highDosageVal1=dosageVal0;
             if(splitSinglePoptRun){//if so, will need to check every Tf1 dosage
                 highDosageVal1=maxBitstringVal-1;}
+            std::vector<uint64_t> dosageVal1s;
+            for(uint64_t dosageVal1=0;dosageVal1<=highDosageVal1;++dosageVal1){
+                dosageVal1s.push_back(dosageVal1);}
+            if(bestFirst.enabled_){
+                bestFirst.Order(dosageVal1s);}
 //            for(uint64_t dosageVal1=0;dosageVal1<=dosageVal0;++dosageVal1){//2nd TF allele dosage // dosageVal1=3
-            for(uint64_t dosageVal1=0;dosageVal1<=highDosageVal1;++dosageVal1){//2nd TF allele dosage
+            for(unsigned long d1=0;d1<dosageVal1s.size();++d1){//2nd TF allele dosage
+                uint64_t dosageVal1=dosageVal1s[d1];
+                if(phenotypeIndex.enabled_ && !phenotypeIndex.DosagesCanReach(dosageVal0,dosageVal1,Popt,omega,
+                                                                              nearOptimal.Bound(maxPopMeanFitness))){
+                    threadRunStatistics.prunedGtypes_+=(tfVal0+1)*sweepProgress.pairsBelow(maxBitstringVal);//every tfVal1 & cis pair
+                    continue;}
                 gtypeSet.dosageVal1_=dosageVal1;
                 focalIndiv.SetGenotype(0,1,dosageVal1);
                 std::thread refThread;
@@ -4794,10 +7528,12 @@ void MaximizeUsingBitstringsThreadableAllCis(int bitstringLen, long double Ntfsa
                             focalIndiv.SetGenotype(1,1,tfVal1counter);
                             int solutionEqualsMaxOrBetter=false;
                             FitnessMaximaSolutionSets newSolutionSummaries(splitSinglePoptRun,lowTf0dosage,highTf0dosage);
+                            TraceSpan mainThreadTask(0,"MaximizeUsingBitstringsAllCisGtypes");
                             MaximizeUsingBitstringsAllCisGtypes(&focalIndiv,&simSet,&gtypeSet,&newSolutionSummaries,
                                     maxPopMeanFitness,&solutionEqualsMaxOrBetter);
-                            if(solutionEqualsMaxOrBetter){
-                                maxPopMeanFitness=newSolutionSummaries.wBarMax(Popt);
+                            mainThreadTask.End();
+                            if(solutionEqualsMaxOrBetter){//an empty set (nothing as good) says -1, so don't lose the bound
+                                maxPopMeanFitness=MAX(maxPopMeanFitness,newSolutionSummaries.wBarMax(Popt));
                                 summariesOfSolutions.ConcatenateSolutions(newSolutionSummaries);}
                             tfVal1counter++;
                             }
@@ -4825,13 +7561,15 @@ void MaximizeUsingBitstringsThreadableAllCis(int bitstringLen, long double Ntfsa
                                 genotypeSettings *gset = &(gtypeSettingsList[t]);
                                 simulationSettings *simset = &(simSettingsList[t]);
                                 int *sameOrBetter = &(solutionSameOrBetterTF[t]);
-                                std::thread th(
+                                std::thread th=TracedThread(t+1,"MaximizeUsingBitstringsAllCisGtypes",
                                     MaximizeUsingBitstringsAllCisGtypes,fIndiv,simset,gset,fmss,
                                                     maxPopMeanFitness,sameOrBetter);
                                 threadList.push_back(move(th));
                                 }//t
+                            TraceSpan joinSpan(0,"join barrier",(int)threadList.size());
                             for(int t=0;t<threadList.size();++t){//synchronize threads
                                 threadList[t].join();}//t=6
+                            joinSpan.End();
                             for(int t=0;t<threadList.size();++t){//collect data
                                 if(solutionSameOrBetterTF[t]){
                                     if(summariesOfSolutions.wBarMax(Popt)<=newSolutionSummaries[t].wBarMax(Popt)){
@@ -4844,32 +7582,106 @@ void MaximizeUsingBitstringsThreadableAllCis(int bitstringLen, long double Ntfsa
                             }//make & use threads
                     }//while tfVal0Counter
               }//dosageVal1
+            sweepProgress.Add(dosageVal0,tfVal0,summariesOfSolutions.wBarMax(Popt));
             }//tfVal0
         }//dosageVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
+    warmStart.Remember(summariesOfSolutions,Popt);
     }//MaximizeUsingBitstringsThreadableAllCis
 
 
 
 
+void MaximizeUsingHeuristicSearch(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage,
+                long double deltaG1, long double minExpression, long double maxExpression,
+                long double Popt, long double omega,
+                FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries){
+    //for long bitstrings: heuristicSearch's best reference genotypes stand in for the full sweep
+    std::stringstream msg;
+    msg<<"searching for Popt="<<Popt<<" and omega="<<omega<<" ("<<heuristicSearch.restarts_<<" starts)";
+    logger.Log(logInfo,msg.str());
+    simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
+    heuristicSearch.Search(simSet,summariesOfSolutions);
+    logger.Log(logInfo,"\n**************************");
+    summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
+    }//MaximizeUsingHeuristicSearch
+
+
+
+
+void EstimatePrevalenceBySampling(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage,
+                long double deltaG1, long double minExpression, long double maxExpression,
+                long double Popt, long double omega,
+                FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries,
+                std::ostream& outputfilePrevalence){
+    //for long bitstrings: het-code prevalence from uniformly sampled reference genotypes; the summary table gets
+    //the best of the sampled genotypes
+    std::stringstream msg;
+    msg<<"sampling "<<prevalenceSampler.samples_<<" reference g'types for Popt="<<Popt<<" and omega="<<omega;
+    logger.Log(logInfo,msg.str());
+    simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
+    prevalenceSampler.Sample(simSet,summariesOfSolutions,&outputfilePrevalence);
+    logger.Log(logInfo,"\n**************************");
+    summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
+    }//EstimatePrevalenceBySampling
+
+
+
+
+void MaximizeUsingMismatchClasses(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage,
+                long double deltaG1, long double minExpression, long double maxExpression,
+                long double Popt, long double omega,
+                FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries,
+                bool splitSinglePoptRun, uint64_t lowTf0dosage, uint64_t highTf0dosage){
+    //the same loop space as MaximizeUsingBitstringsThreadableAllCis, one g'type per mismatch class
+    std::stringstream msg; msg<<"maximizing over mismatch classes for Popt="<<Popt<<" and omega="<<omega;
+    if(splitSinglePoptRun){
+        msg<<" for tf0 dosage "<<lowTf0dosage;
+        if(highTf0dosage>lowTf0dosage){
+            msg<<" to "<<highTf0dosage;}
+        }
+    logger.Log(logInfo,msg.str());
+    uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
+    if(!splitSinglePoptRun){//to eliminate any ambiguity
+        lowTf0dosage=0; highTf0dosage=maxBitstringVal-1;}
+    mismatchClasses.Build(bitstringLen,splitSinglePoptRun,lowTf0dosage,highTf0dosage);
+    simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega,
+                                splitSinglePoptRun,lowTf0dosage,highTf0dosage);
+    int availableThreads = MAX((unsigned int)1,std::thread::hardware_concurrency());
+    int threadsToUse = MIN(availableThreads,16);
+    std::vector<FitnessMaximaSolutionSets> found(threadsToUse,FitnessMaximaSolutionSets(splitSinglePoptRun,lowTf0dosage,highTf0dosage));
+    std::vector<std::thread> threadList;
+    for(int t=0;t<threadsToUse;++t){
+        threadList.push_back(std::thread(&MismatchClasses::MaximizeThread,&mismatchClasses,&simSet,t,threadsToUse,&(found[t])));}
+    for(unsigned long t=0;t<threadList.size();++t){
+        threadList[t].join();
+        summariesOfSolutions.ConcatenateSolutions(found[t]);}
+    logger.Log(logInfo,"\n**************************");
+    summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
+    }//MaximizeUsingMismatchClasses
+
+
+
+
 void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long double deltaG1dosage,
                 long double deltaG1, long double minExpression, long double maxExpression,
                 long double Popt, long double omega,
                 FitnessMaximaBitstringSolutions& wBarMaxAllSolutions, std::ostream& outputfileAllSolutions, bool saveAllSolutions,
                 FitnessMaximaSolutionSets& summariesOfSolutions, std::ostream& outputfileSolutionSummaries,
                 bool splitSinglePoptRun, uint64_t lowTf0dosage, uint64_t highTf0dosage){
-    coutLock.lock();
-    std::cout<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
+    std::stringstream msg;
+    msg<<"maximizing for Popt="<<Popt<<" and omega="<<omega;
     if(splitSinglePoptRun){
-        std::cout<<" for tf0 dosage "<<lowTf0dosage;
+        msg<<" for tf0 dosage "<<lowTf0dosage;
         if(highTf0dosage>lowTf0dosage){
-            std::cout<<" to "<<highTf0dosage;}
+            msg<<" to "<<highTf0dosage;}
         }
-    std::cout<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,msg.str());
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
      if(!splitSinglePoptRun){//to eliminate any ambiguity
         lowTf0dosage=0; highTf0dosage=maxBitstringVal-1;}
+    sweepProgress.Start(Popt,maxBitstringVal,splitSinglePoptRun,lowTf0dosage,highTf0dosage);
     SimplestRegPathIndividual indivAABB(false), indivAABb(false), indivAAbb(false);//recombinants
     SimplestRegPathIndividual indivAaBB(false), indivAaBb(false), indivAabb(false);//
     SimplestRegPathIndividual indivaaBB(false), indivaaBb(false), indivaabb(false);
@@ -4904,13 +7716,16 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                             for(int i=0;i<4;++i){pNeutral[i]=qNeutral[i]=false;}
                             wAABB=wAABb=wAAbb=wAaBB=wAaBb=wAabb=waaBB=waaBb=waabb=-one;
                             phAABB=phAABb=phAAbb=phAaBB=phAaBb=phAabb=phaaBB=phaaBb=phaabb=-one;
+                            threadPhaseProfile.Begin(phenotypePhase);
                             focalIndiv.CalculatePhenotype(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression);
                             focalIndiv.CalculateFitness(Popt,omega);
-                            std::string focalGtypeBitstringStr=focalIndiv.gtypeString(bitstringLen);
+                            GenotypeKey focalGtypeKey=focalIndiv.gtypeKey(bitstringLen);
                             std::string focalGtypeMismatchStr=focalIndiv.mismatchStringMathematicaFormat();
                             //create recombinant genotypes
                             int numMaxima=0;
+                            threadRunStatistics.referenceGtypes_++;
                             if(focalIndiv.IsTFheterozygote() && focalIndiv.IsCisHeterozygote()){//maximize for p & q
+                                    threadRunStatistics.doubleHets_++;
                                     indivAaBb=focalIndiv;
                                     
                                     indivAABB.TFdosage_[0]=indivAABB.TFdosage_[1]=dosageVal0;
@@ -4988,10 +7803,13 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                                     waabb=indivaabb.CalculateFitness(Popt,omega);
                                 
                                 //maximize for p & q
-                                MaximizePopMeanFitnessPandQv2(wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb,popMeanFitness,phat,qhat,pNeutral,qNeutral,numMaxima,focalGtypeBitstringStr);
+                                threadPhaseProfile.End(phenotypePhase); threadPhaseProfile.Begin(landscapePhase);
+                                MaximizePopMeanFitnessPandQv2(wAABB,wAABb,wAAbb,wAaBB,wAaBb,wAabb,waaBB,waaBb,waabb,popMeanFitness,phat,qhat,pNeutral,qNeutral,numMaxima,focalGtypeKey);
                                 collectMeanPhenotypesPQ(phAABB,phAABb,phAAbb,phAaBB,phAaBb,phAabb,phaaBB,phaaBb,phaabb,phat,qhat,popMeanPhenotypes,numMaxima);
+                                threadPhaseProfile.End(landscapePhase);
                                     }
                                 else if(focalIndiv.IsTFheterozygote()){//maximize for p
+                                    threadRunStatistics.tfHets_++;
                                     indivAaBB=focalIndiv;
                                     
                                     indivAABB.TFdosage_[0]=indivAABB.TFdosage_[1]=dosageVal0;
@@ -5013,11 +7831,14 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                                     wAABB=indivAABB.CalculateFitness(Popt,omega);
                                     wAaBB=focalIndiv.fitness();
                                     waaBB=indivaaBB.CalculateFitness(Popt,omega);
+                                    threadPhaseProfile.End(phenotypePhase); threadPhaseProfile.Begin(landscapePhase);
                                     MaximizePopMeanFitnessP(wAABB,wAaBB,waaBB,popMeanFitness,phat,pNeutral,numMaxima);
                                     for(int m=0;m<numMaxima;++m){qhat[m]=one;qNeutral[m]=false;}
                                     collectMeanPhenotypesP(phAABB,phAaBB,phaaBB,phat,popMeanPhenotypes,numMaxima);
+                                    threadPhaseProfile.End(landscapePhase);
                                     }
                                 else if(focalIndiv.IsCisHeterozygote()){//maximize for q
+                                    threadRunStatistics.cisHets_++;
                                     indivAABb = focalIndiv;
                                     
                                     indivAABB.TFdosage_[0]=indivAABB.TFdosage_[1]=dosageVal0;
@@ -5038,11 +7859,15 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                                     wAABB=indivAABB.CalculateFitness(Popt,omega);
                                     wAABb=focalIndiv.fitness();
                                     wAAbb=indivAAbb.CalculateFitness(Popt,omega);
+                                    threadPhaseProfile.End(phenotypePhase); threadPhaseProfile.Begin(landscapePhase);
                                     MaximizePopMeanFitnessQ(wAABB,wAABb,wAAbb,popMeanFitness,qhat,qNeutral,numMaxima);
                                     for(int m=0;m<numMaxima;++m){phat[m]=one;pNeutral[m]=false;}
                                     collectMeanPhenotypesQ(phAABB,phAABb,phAAbb,qhat,popMeanPhenotypes,numMaxima);
+                                    threadPhaseProfile.End(landscapePhase);
                                     }
                                 else{//double homozygote AABB
+                                    threadRunStatistics.homozygotes_++;
+                                    threadPhaseProfile.End(phenotypePhase);
                                     indivAABB=focalIndiv;
                                     phAABB=focalIndiv.phenotype();
                                     wAABB=focalIndiv.fitness();
@@ -5053,6 +7878,7 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                                     popMeanPhenotypes[0]=focalIndiv.phenotype();
                                     }
 
+                            threadPhaseProfile.Begin(bookkeepingPhase);
                             popMeanFitness=MIN(MAX(ROUND(popMeanFitness,decimalDigitsToRound),zero),one);
                             for(int m=0;m<numMaxima;++m){
                                 popMeanPhenotypes[m]=MIN(MAX(ROUND(popMeanPhenotypes[m],decimalDigitsToRound),zero),one);}
@@ -5061,6 +7887,7 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                             
                             
                             if(popMeanFitness==maxPopMeanFitness){
+                                threadRunStatistics.ties_++;
 
                                 for(int m=0;m<numMaxima;++m){
                                     if(phat[m]==-one && qhat[m]==-one) break;//reached the end
@@ -5163,21 +7990,21 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                                     if(!pNeutral[m]){pMostCommon=MAX(phat[m],one-phat[m]);}
                                     if(!qNeutral[m]){qMostCommon=MAX(qhat[m],one-qhat[m]);}
                                     solutionIndiv.SetMismatchesUsingBitstrings();
-                                    std::string solGtype=solutionIndiv.gtypeString(bitstringLen);
-                                    std::string refGtype=focalIndiv.gtypeString(bitstringLen);
                                     std::string mhp = solutionIndiv.mismatchHetType();
                                     std::string mp = solutionIndiv.mismatchStringMathematicaFormat();
                                     int hc = codeToInt(ht), mhc = codeToInt(mhp);
                                     FitnessMaximumSolutionSet thisSolutionSummary(Popt,omega,NtfsatPerAllele,bitstringLen,popMeanFitness,
                                                                                   popMeanPhenotypes[m],pMostCommon,
                                                                                   qMostCommon,pNeutral[m],qNeutral[m],
-                                                                                  hc,ht,mhc,mhp,mp,solGtype,refGtype,
+                                                                                  hc,ht,mhc,mhp,mp,
                                                                                   splitSinglePoptRun,lowTf0dosage,highTf0dosage);
+                                    thisSolutionSummary.SetFirstGtypes(solutionIndiv,focalIndiv);
                                     summariesOfSolutions.AddSolution(thisSolutionSummary);
                                     }//m
                                 }//popMeanFitness==maxPopMeanFitness
  
                             if(popMeanFitness>maxPopMeanFitness){
+                                threadRunStatistics.newMaxima_++;
                                 newBest=true;
                                 for(int m=0;m<numMaxima;++m){
                                     SimplestRegPathIndividual solutionIndiv;
@@ -5277,19 +8104,19 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                                     if(!pNeutral[m]){pMostCommon=MAX(phat[m],one-phat[m]);}
                                     if(!qNeutral[m]){qMostCommon=MAX(qhat[m],one-qhat[m]);}
                                     solutionIndiv.SetMismatchesUsingBitstrings();
-                                    std::string solGtype=solutionIndiv.gtypeString(bitstringLen);
-                                    std::string refGtype=focalIndiv.gtypeString(bitstringLen);
                                     std::string mhp = solutionIndiv.mismatchHetType();
                                     std::string mp = solutionIndiv.mismatchStringMathematicaFormat();
                                     int hc = codeToInt(ht), mhc = codeToInt(mhp);
                                     FitnessMaximumSolutionSet thisSolutionSummary(Popt,omega,NtfsatPerAllele,bitstringLen,popMeanFitness,
                                                                                   popMeanPhenotypes[m],pMostCommon,
                                                                                   qMostCommon,pNeutral[m],qNeutral[m],
-                                                                                  hc,ht,mhc,mhp,mp,solGtype,refGtype,
+                                                                                  hc,ht,mhc,mhp,mp,
                                                                                   splitSinglePoptRun,lowTf0dosage,highTf0dosage);
+                                    thisSolutionSummary.SetFirstGtypes(solutionIndiv,focalIndiv);
                                     summariesOfSolutions.AddSolution(thisSolutionSummary);
                                     }//m
                                 }//popMeanFitness>maxPopMeanFitness
+                            threadPhaseProfile.End(bookkeepingPhase);
                             }//cisVal1
                         }//cisVal0
                     //could end a thread here that maximized fitness over the whole cis parameter space for this TF pair
@@ -5297,9 +8124,10 @@ void MaximizeUsingBitstrings(int bitstringLen, long double NtfsatPerAllele, long
                     //these would be concatenated to the global FitnessMaximaSolutionSets
                     }//tfVal1
                 }//dosageVal1
+            sweepProgress.Update(dosageVal0,tfVal0,maxPopMeanFitness);
             }//tfVal0
         }//dosageVal0
-    coutLock.lock(); std::cout<<std::endl<<"**************************"<<std::endl; coutLock.unlock();
+    logger.Log(logInfo,"\n**************************");
     summariesOfSolutions.PrintDataByPopt(outputfileSolutionSummaries, Popt);
     }//maximizeUsingBitstrings
 
@@ -5459,6 +8287,51 @@ void DetermineViableMismatchCombinations(int bitstringLen){
 
 
 
+void ExtractRunOptions(int& argc, const char * argv[], std::vector<std::string>& options){
+    //moves any --name or --name=value arguments out of argv, so the positional parameters keep their places
+    int positional=0;
+    for(int i=0;i<argc;++i){
+        std::string arg(argv[i]);
+        if(i>0 && arg.compare(0,2,"--")==0){
+                options.push_back(arg.substr(2));}
+            else{
+                argv[positional++]=argv[i];}
+        }//i
+    argc=positional;
+    }//ExtractRunOptions
+
+
+bool RunOptionSet(std::vector<std::string>& options, std::string name){
+    for(unsigned long i=0;i<options.size();++i){
+        if(options[i]==name || options[i].compare(0,name.length()+1,name+"=")==0){ return true;}}
+    return false;}
+
+
+std::string RunOptionValue(std::vector<std::string>& options, std::string name, std::string defaultValue){
+    //returns the value of --name=value, or defaultValue if it isn't there
+    for(unsigned long i=0;i<options.size();++i){
+        if(options[i].compare(0,name.length()+1,name+"=")==0){ return options[i].substr(name.length()+1);}}
+    return defaultValue;}
+int RunOptionValueList(std::vector<std::string>& options, std::string name, std::vector<long double>& values){
+    //appends the comma-separated numbers in --name=v1,v2,... to values; returns how many, or -1 if one won't parse
+    std::string list=RunOptionValue(options,name,"");
+    int count=0;
+    std::string::size_type start=0;
+    while(start<list.length()){
+        std::string::size_type comma=list.find(',',start);
+        if(comma==std::string::npos){comma=list.length();}
+        std::string item=list.substr(start,comma-start);
+        start=comma+1;
+        if(item.length()==0){continue;}
+        char* end=NULL;
+        long double value=std::strtold(item.c_str(),&end);
+        if(end==item.c_str() || *end!='\0'){ return -1;}
+        values.push_back(value);
+        ++count;}
+    return count;}
+
+
+
 using namespace std;
 int main(int argc, const char * argv[]) {
     /*
@@ -5475,6 +8348,66 @@ int main(int argc, const char * argv[]) {
             #this runs the simulation with bitstringLen=3, but just for Popt=0.01 (steps and step size are irrelevant)
         ./fitnessOverdomOptGtype 3 1 1 100 1
             #this does the same thing
+    options can go anywhere on the line, and don't count as positional parameters:
+        --progress-interval=SECONDS    how often to write progress records to stderr & the status file (default 60; 0 = end of each Popt only)
+        --no-progress                  turn progress records off
+        --profile                      time the phenotype / landscape solve / bookkeeping / output phases of each Popt
+        --perf-counters                as --profile, plus cycles, instructions, cache misses & branch misses (linux only)
+        --trace=FILE                   write a Chrome/Perfetto trace of the thread batches to FILE
+        --log-level=LEVEL              debug, info (default), warning or error; repeated warnings are rate limited
+        --binary-summary               also write the summary table as columns to fitnessOverdomSummaryTable....bin
+                                       (rewritten after each Popt, so an interrupted run keeps the Popts it finished)
+        --bin-to-tsv=FILE              just convert a .bin summary back to the text table (FILE minus .bin, plus _fromBinary.txt)
+        --tsv-out=FILE                 with --bin-to-tsv or --read-shared-log, write the text table to FILE instead
+        --phenotype-cache=DIR          share the phenotype table through a file in DIR, mmap'd by every run on the node
+                                       (built & written by the first run that needs it)
+        --shared-log=FILE              append each Popt's results to FILE (shared by all shard processes) instead of
+                                       writing a summary table per run
+        --read-shared-log=FILE         just rebuild the summary table from a shared log, keeping the shards that reach
+                                       each Popt's highest wBarMax (FILE minus .log, plus _maxima.txt)
+        --omegas=W1,W2,...             run every Popt for each of these omegas in turn (instead of the one on the line);
+                                       each omega re-runs the whole enumeration, only the phenotype table build & the
+                                       min/max expression are shared; each omega gets its own _o... summary & status files
+        --refine-popt[=RES]            adaptive Popt grid: after the usual grid, keep bisecting between neighbouring Popts whose
+                                       winning het/mismatch patterns differ until they're RES/PoptSteps apart (default 1);
+                                       rows are written in the order the Popts are run
+        --no-warm-start                start each Popt's sweep from wBar=-1 instead of from the last Popt's winners
+        --best-first                   sweep the TF dosage alleles whose homozygotes can get closest to Popt first; same
+                                       wBarMax & het patterns, but which g'type represents a row (1st g'types, mismatch
+                                       pattern), how solutions within tol_ are grouped, and the row order can differ
+        --search                       find the best reference genotypes by multi-start local search (single-bit flips,
+                                       random kicks) instead of the full enumeration, for bitstringLen 8-12; its tables
+                                       are named *_search.txt, and items counts the distinct g'types it reached
+        --search-restarts=N            random starts per Popt (default 64), spread over the threads
+        --search-kicks=N               kicks from each start's local maximum (default 20)
+        --search-seed=S                RNG seed (default 20210228); thread t uses its own stream from it
+        --validate-search              run the enumeration and the search at each Popt, and log whether the search
+                                       found the same wBarMax & het patterns (for bitstringLen 3-5)
+        --no-phenotype-prune           visit every reference genotype, even those that can't reach the running maximum wBar
+                                       because all the genotypes they make have phenotypes too far from Popt
+        --mismatch-classes             maximize once per class of reference genotypes with the same mismatch counts &
+                                       het sites, and count the class sizes into the items column, instead of visiting
+                                       every genotype (full model only)
+        --sample=N                     estimate how often each het code is the optimum from N uniformly drawn reference
+                                       genotypes per Popt (1e9 is fine), instead of the full enumeration; writes
+                                       polymorphismPrevalence*.txt with 95% intervals, and the best sampled g'types
+                                       to the summary table (named *_sample.txt; items counts draws)
+        --sample-report=N              log & write the counts so far every N samples (default: only at the end)
+        --sample-seed=S                RNG seed (default 20210228); the counts for a seed don't depend on #threads
+        --het-code-maxima              also write hetCodeMaxima*.txt: the best wBar each het code reaches at each Popt,
+                                       how far it is below wBarMax, and an example reference g'type (turns off the
+                                       phenotype pruning, since a pruned g'type can be a code's best)
+        --near-optimal=K               also write nearOptimal*.txt: the K best distinct solutions at each Popt (summary
+                                       table rows, with their rank & how far below wBarMax), not just the ties
+        --near-optimal-band=EPS        keep the solutions within EPS of wBarMax instead (at most K, default 1000);
+                                       both turn off the warm start, whose g'types would be counted twice
+        --save-all-solutions           also write fitnessOverdominanceDataTable*.txt: every solution at each Popt's wBarMax,
+                                       with how many reference g'types give it, the first of them, and one row per
+                                       distinct fitness landscape (not with --mismatch-classes, --search or --sample;
+                                       turns off the warm start)
+        --ntfsats=N1,N2,...            run everything for each of these Ntfsat values in turn (instead of the one on the line);
+                                       Ntfsat needn't be 10, 30, 100, 300 or 1000, the deltaGs are worked out from it, and
+                                       each Ntfsat gets its own phenotype table & _Ntf... summary & status files
     */
         
 /*
@@ -5557,7 +8490,7 @@ int main(int argc, const char * argv[]) {
 */
 	
 	int bitstringLen = 4;
-    int Ntfsat_int=10;//Ntfsat->{10,30,100,300,1000} ->set the deltaG values too
+    long double NtfsatPerAllele=10;//Ntfsat->{10,30,100,300,1000} use the preset deltaG values; see NtfsatDeltaGs()
     int PoptLow=0, PoptSteps=1000, PoptStepSize=5;
     int PoptHigh=1000;
     bool saveAllSolutions=false;//if false, then only the summary table is saved
@@ -5566,11 +8499,12 @@ int main(int argc, const char * argv[]) {
     bool splitSinglePoptRun=false;
     typeOfModelToRun modelToRun=allSites;
     string outputSummaryFileDesignator, outputSummaryFileHeaderDesignator;
+    string omegaTag;//the "_o..." part of outputSummaryFileDesignator, if omega is in it
+    string NtfsatTag;//the "_Ntf..." part
     bool printSeparateHeaderFile=false;//use this for concatenating files outside
 //    std::string bb="3";//debugging
 //    outputSummaryFileHeaderDesignator="_b"+bb+"_header";
     long double omega= (long double)0.05;//0.05, 0.2, 0.005
-	long double NtfsatPerAllele;
 	long double deltaG1dosage = (long double) -7.90249;//corresponding deltaG->{-3.89182, -5.66643, -7.90249, -10.0478, -12.4372}
 	long double deltaG1 = (long double) -7.86365;//correspondng deltaG->{-3.58352, -5.54518, -7.86365, -10.0346, -12.4332}
     uint64_t maxBitstringVal = uint64_t(pow(2,bitstringLen));
@@ -5583,6 +8517,18 @@ int main(int argc, const char * argv[]) {
 //    PoptLow=PoptHigh=195;
                 for(int i=0;i<argc;++i){
                     std::cout<<"argv["<<i<<"]="<<argv[i]<<std::endl;}
+    std::vector<std::string> runOptions;
+    ExtractRunOptions(argc,argv,runOptions);
+    if(RunOptionValue(runOptions,"bin-to-tsv","").length()>0){//convert & quit
+        std::string binName=RunOptionValue(runOptions,"bin-to-tsv","");
+        std::string tsvName=binName.substr(0,binName.rfind(".bin"))+"_fromBinary.txt";
+        tsvName=RunOptionValue(runOptions,"tsv-out",tsvName);
+        return (ConvertBinarySummaryToTSV(binName,tsvName)==-1) ? 1 : 0;}
+    if(RunOptionValue(runOptions,"read-shared-log","").length()>0){//reconstruct the per-Popt maxima & quit
+        std::string logName=RunOptionValue(runOptions,"read-shared-log","");
+        std::string tsvName=logName.substr(0,logName.rfind(".log"))+"_maxima.txt";
+        tsvName=RunOptionValue(runOptions,"tsv-out",tsvName);
+        return (ReconstructMaximaFromSharedLog(logName,tsvName)==-1) ? 1 : 0;}
     
     if(argc>=8){//get parameters off the input line
             std::string b=argv[1];
@@ -5596,7 +8542,7 @@ int main(int argc, const char * argv[]) {
             std::string::size_type sz;
             bitstringLen=std::stoi(b,&sz);
             maxBitstringVal = uint64_t(pow(2,bitstringLen));
-            Ntfsat_int=std::stoi(n,&sz);
+            NtfsatPerAllele=std::stold(n,&sz);
             omega=std::stold(o,&sz);
             PoptLow=std::stoi(pl,&sz);
             PoptLow = MAX(0,PoptLow);
@@ -5605,12 +8551,12 @@ int main(int argc, const char * argv[]) {
             PoptHigh = MIN(PoptHigh,PoptSteps);
             PoptStepSize=std::stoi(pss,&sz);
             runningInSegments=true;
-            saveAllSolutions=false;//should be anyway
             outputSummaryFileHeaderDesignator="_b"+b+"_Ntf"+n+"_header";
             float poptlow = (float)PoptLow/(float)PoptSteps;
             float popthigh = (float)PoptHigh/(float)PoptSteps;
             stringstream sspl; sspl << poptlow;
             outputSummaryFileDesignator+="_b"+b+"_Ntf"+n+"_Popt"+sspl.str();
+            NtfsatTag="_Ntf"+n;
             if(PoptHigh>PoptLow){
                 stringstream ssph; ssph << popthigh;
                 outputSummaryFileDesignator+="to"+ssph.str();}
@@ -5639,7 +8585,7 @@ int main(int argc, const char * argv[]) {
             tf0High=MIN(tf0High,maxBitstringVal-1);
             std::stringstream bb, nn, oo, tflow, tfhigh, pp;
             bb<<bitstringLen;
-            nn<<Ntfsat_int;
+            nn<<NtfsatPerAllele;
             oo<<omega;
             tflow<<tf0Low;
             tfhigh<<tf0High;
@@ -5655,6 +8601,8 @@ int main(int argc, const char * argv[]) {
             std::string p = pp.str();
             outputSummaryFileHeaderDesignator="_b"+b+"_Ntf"+n+"_header";
             outputSummaryFileDesignator+="_b"+b+"_Ntf"+n+"_o"+o;
+            omegaTag="_o"+o;
+            NtfsatTag="_Ntf"+n;
             if(splitSinglePoptRun){
                 outputSummaryFileDesignator+=+"_Popt"+p+"_tf"+tL;
                 if(tf0High>tf0Low){
@@ -5663,28 +8611,25 @@ int main(int argc, const char * argv[]) {
             }
 //	long double deltaG1dosage = (long double) -7.90249;//corresponding deltaG->{-3.89182, -5.66643, -7.90249, -10.0478, -12.4372}
 //	long double deltaG1 = (long double) -7.86365;//correspondng deltaG->{-3.58352, -5.54518, -7.86365, -10.0346, -12.4332}
-    NtfsatPerAllele=(long double)Ntfsat_int;
-    switch(Ntfsat_int){
-        case 10:
-            deltaG1dosage=-3.89182; deltaG1=-3.58352;
-            break;
-        case 30:
-            deltaG1dosage=-5.66643; deltaG1=-5.54518;
-            break;
-        case 300:
-            deltaG1dosage=-10.0478; deltaG1=-10.0346;
-            break;
-        case 1000:
-            deltaG1dosage=-12.4372; deltaG1=-12.4332;
-            break;
-        default: //case 100
-            deltaG1dosage=-7.90249; deltaG1=-7.86365;
-          break;
-        }
 	SimplestRegPathIndividual minmaxIndiv;
 	long double minExpression=zero,maxExpression=zero;
-	minmaxIndiv.CalculateMinMaxExpression(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,
-			minExpression,maxExpression,modelToRun);
+    std::vector<long double> ntfsats;//a batch of Ntfsat values, each with its own deltaGs & phenotype table
+    if(RunOptionValueList(runOptions,"ntfsats",ntfsats)==-1){
+        logger.Log(logError,"can't read the list of Ntfsat values "+RunOptionValue(runOptions,"ntfsats",""),true);
+        return 1;}
+    bool ntfsatsListed=(ntfsats.size()>0);//then the file names say which Ntfsat they're for
+    if(!ntfsatsListed){ntfsats.push_back(NtfsatPerAllele);}
+    for(unsigned long v=0;v<ntfsats.size();++v){
+        if(!(ntfsats[v]>zero)){
+            logger.Log(logError,"Ntfsat has to be positive",true);
+            return 1;}}
+    std::vector<long double> omegas;//none of the phenotype work depends on omega, so a sweep shares it
+    if(RunOptionValueList(runOptions,"omegas",omegas)==-1){
+        logger.Log(logError,"can't read the list of omegas "+RunOptionValue(runOptions,"omegas",""),true);
+        return 1;}
+    bool omegasListed=(omegas.size()>0);//then the file names say which omega they're for
+    if(!omegasListed){omegas.push_back(omega);}
+    bool sweepingOmega=(omegas.size()>1);
 	
 //	long double Popt= (long double)0.60;
 
@@ -5751,90 +8696,285 @@ int main(int argc, const char * argv[]) {
 	std::vector<std::string> bestGtypes, bestMismatchGtypes, bestHetType, bestPs, bestQs;
 	std::string bestMismatchGtype,pBest,qBest,phBest;
     
+    saveAllSolutions=RunOptionSet(runOptions,"save-all-solutions");
+    if(saveAllSolutions && (RunOptionSet(runOptions,"mismatch-classes") || RunOptionSet(runOptions,"search")
+                            || RunOptionSet(runOptions,"sample"))){//none of these visits every reference g'type
+        logger.Log(logError,"--save-all-solutions can't be used with --mismatch-classes, --search or --sample",true);
+        return 1;}
+    heuristicSearch.validating_=RunOptionSet(runOptions,"validate-search");
+    heuristicSearch.enabled_=RunOptionSet(runOptions,"search") && !heuristicSearch.validating_;
+    heuristicSearch.restarts_=MAX(1,std::atoi(RunOptionValue(runOptions,"search-restarts","64").c_str()));
+    heuristicSearch.kicks_=MAX(0,std::atoi(RunOptionValue(runOptions,"search-kicks","20").c_str()));
+    heuristicSearch.seed_=std::strtoull(RunOptionValue(runOptions,"search-seed","20210228").c_str(),NULL,10);
+    std::string modeDesignator, itemsColumn("items");//these tables aren't the enumeration's, so they get their own file names
+    if(heuristicSearch.enabled_){
+        modeDesignator="_search";
+        itemsColumn="items (distinct ref g'types the search reached)";}
+    prevalenceSampler.samples_=(uint64_t)std::strtold(RunOptionValue(runOptions,"sample","0").c_str(),NULL);//1e9 is fine
+    prevalenceSampler.enabled_=(prevalenceSampler.samples_>0);
+    prevalenceSampler.reportEvery_=(uint64_t)std::strtold(RunOptionValue(runOptions,"sample-report","0").c_str(),NULL);
+    prevalenceSampler.seed_=std::strtoull(RunOptionValue(runOptions,"sample-seed","20210228").c_str(),NULL,10);
+    if(prevalenceSampler.enabled_ && (heuristicSearch.enabled_ || heuristicSearch.validating_)){
+        logger.Log(logError,"--sample can't be used with --search or --validate-search",true);
+        return 1;}
+    if(prevalenceSampler.enabled_){
+        modeDesignator="_sample";
+        itemsColumn="items (sampled ref g'types, repeats included)";}
     std::string outputfileAllSolutionsName("fitnessOverdominanceDataTable");
     outputfileAllSolutionsName += outputSummaryFileDesignator+".txt";
     char* outputfileAllSolutionsNameStr = new char[outputfileAllSolutionsName.length()+1];
     std::strcpy(outputfileAllSolutionsNameStr,outputfileAllSolutionsName.c_str());
     std::fstream outputfileAllSolutions;
     FitnessMaximaBitstringSolutions wBarMaxAllSolutions;//(splitSinglePoptRun,tf0Low,tf0High);
+    allSolutions.target_=&wBarMaxAllSolutions;
+    allSolutions.enabled_=saveAllSolutions;
     if(saveAllSolutions){
         outputfileAllSolutions.open(outputfileAllSolutionsNameStr,std::fstream::out);
         outputfileAllSolutions.close();
         outputfileAllSolutions.open(outputfileAllSolutionsNameStr,std::fstream::app);
         wBarMaxAllSolutions.PrintSolutionTableHeader(outputfileAllSolutions);}
+    BufferedTableWriter allSolutionsWriter(outputfileAllSolutions);
 
-    std::string outputfileSolutionSummariesName("fitnessOverdomSummaryTable");
-    outputfileSolutionSummariesName += outputSummaryFileDesignator+".txt";
-    char* outputfileSolutionSummariesNameStr = new char[outputfileSolutionSummariesName.length()+1];
-    std::strcpy(outputfileSolutionSummariesNameStr,outputfileSolutionSummariesName.c_str());
+    std::string outputfileSolutionSummariesName;
     std::fstream outputfileSolutionSummaries,outputfileSolutionSummariesHeader;
-    outputfileSolutionSummaries.open(outputfileSolutionSummariesNameStr,std::fstream::out);//overwrites
-    outputfileSolutionSummaries.close();
-    outputfileSolutionSummaries.open(outputfileSolutionSummariesNameStr,std::fstream::app);
+    SharedResultsLog sharedLog;
+    if(RunOptionValue(runOptions,"shared-log","").length()>0){//no per-run summary or header files; their output is dropped
+            if(sweepingOmega || ntfsats.size()>1){//the records don't say which omega or Ntfsat they're for
+                logger.Log(logError,"--shared-log can't be used with more than one omega or Ntfsat",true);
+                return 1;}
+            if(sharedLog.Open(RunOptionValue(runOptions,"shared-log",""))==-1){
+                logger.Log(logError,"can't open shared results log "+RunOptionValue(runOptions,"shared-log",""),true);
+                return 1;}
+            }
 
     FitnessMaximaSolutionSets summariesOfSolutions(splitSinglePoptRun,tf0Low,tf0High);
-    if(printSeparateHeaderFile){
+    if(!sharedLog.isOpen() && printSeparateHeaderFile){//the log reader writes the header; otherwise one header does for every omega
             std::string outputfileSolutionSummariesHeaderName("fitnessOverdomSummaryTable");
-            outputfileSolutionSummariesHeaderName += outputSummaryFileHeaderDesignator+".txt";
+            outputfileSolutionSummariesHeaderName += outputSummaryFileHeaderDesignator+modeDesignator+".txt";
             char* outputfileSolutionSummariesHeaderNameStr = new char[outputfileSolutionSummariesHeaderName.length()+1];
             std::strcpy(outputfileSolutionSummariesHeaderNameStr,outputfileSolutionSummariesHeaderName.c_str());
             outputfileSolutionSummariesHeader.open(outputfileSolutionSummariesHeaderNameStr,std::fstream::out);//overwrites
             outputfileSolutionSummariesHeader.close();
             outputfileSolutionSummariesHeader.open(outputfileSolutionSummariesHeaderNameStr,std::fstream::app);
             delete [] outputfileSolutionSummariesHeaderNameStr; outputfileSolutionSummariesHeaderNameStr=NULL;
-            summariesOfSolutions.PrintHeaderLine(outputfileSolutionSummariesHeader);
+            summariesOfSolutions.PrintHeaderLine(outputfileSolutionSummariesHeader,itemsColumn);
             outputfileSolutionSummariesHeader.close();
             }
-        else{
-            summariesOfSolutions.PrintHeaderLine(outputfileSolutionSummaries);}
 
 
+    sweepProgress.enabled_=!RunOptionSet(runOptions,"no-progress");
+    sweepProgress.intervalSeconds_=std::stold(RunOptionValue(runOptions,"progress-interval","60"));
+    hardwareCountersEnabled=RunOptionSet(runOptions,"perf-counters");
+    nearOptimal.band_=(RunOptionSet(runOptions,"near-optimal-band")) ?
+            MAX(zero,std::stold(RunOptionValue(runOptions,"near-optimal-band","0"))) : -one;
+    nearOptimal.maxKept_=(unsigned long)MAX(1,std::atoi(RunOptionValue(runOptions,"near-optimal","1000").c_str()));
+    nearOptimal.enabled_=RunOptionSet(runOptions,"near-optimal") || RunOptionSet(runOptions,"near-optimal-band");
+    warmStart.enabled_=!RunOptionSet(runOptions,"no-warm-start") && !nearOptimal.enabled_ && !saveAllSolutions;//seeds would count twice
+    bestFirst.enabled_=RunOptionSet(runOptions,"best-first");
+    mismatchClasses.enabled_=RunOptionSet(runOptions,"mismatch-classes");
+    hetCodeMaxima.enabled_=RunOptionSet(runOptions,"het-code-maxima");
+    phenotypeIndex.enabled_=!RunOptionSet(runOptions,"no-phenotype-prune") && (modelToRun==allSites) && !hetCodeMaxima.enabled_;
+    if(heuristicSearch.validating_ && bitstringLen>5){
+        logger.Log(logWarning,"--validate-search runs the full enumeration too; bitstringLen="+std::to_string(bitstringLen)
+                    +" will take a long time");}
+    phaseProfilingEnabled=hardwareCountersEnabled || RunOptionSet(runOptions,"profile");
+    std::string logLevel=RunOptionValue(runOptions,"log-level","info");
+    if(logLevel=="debug"){logger.minSeverity_=logDebug;}
+    if(logLevel=="warning"){logger.minSeverity_=logWarning;}
+    if(logLevel=="error"){logger.minSeverity_=logError;}
+    if(logLevel!="debug" && logLevel!="info" && logLevel!="warning" && logLevel!="error"){
+        logger.Log(logError,"--log-level must be debug, info, warning or error, not "+logLevel,true);
+        return 1;}
+    logger.Start();
+    if(RunOptionValue(runOptions,"trace","").length()>0){
+        traceRecorder.Open(RunOptionValue(runOptions,"trace",""));}
+    if(saveAllSolutions){allSolutionsWriter.Start();}
+    bool saveBinarySummary=RunOptionSet(runOptions,"binary-summary");
+    bool refinePopt=RunOptionSet(runOptions,"refine-popt");//bisect between grid points whose winning patterns differ
+    int PoptResolution=MAX(1,std::atoi(RunOptionValue(runOptions,"refine-popt","1").c_str()));//...until they're this close (in 1/PoptSteps)
     aTime timer;
-    for(int i=PoptLow;i<=PoptHigh;i+=PoptStepSize){//+=5 normally
-        long double Popt = (long double)i/(long double)PoptSteps;
-        switch(modelToRun){
-            case dosageOnly:
-                MaximizeUsingBitstringsDosageOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
-                    Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
-                    summariesOfSolutions,outputfileSolutionSummaries);
-                break;
-            case tfProductOnly:
-                MaximizeUsingBitstringsTFproductOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
-                    Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
-                    summariesOfSolutions,outputfileSolutionSummaries);
-                break;
-            case cisOnly:
-                MaximizeUsingBitstringsCisOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
-                    Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
-                    summariesOfSolutions,outputfileSolutionSummaries);
-                break;
-            case tfOnly: //dosage & product; always uses threads
-                MaximizeUsingBitstringsTFOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
-                    Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
-                    summariesOfSolutions,outputfileSolutionSummaries);
-                break;
-            default: //allSites
-                if(runUsingThreads){
-                        MaximizeUsingBitstringsThreadableAllCis(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,
-                            minExpression,maxExpression,Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
-                            summariesOfSolutions,outputfileSolutionSummaries,splitSinglePoptRun,tf0Low,tf0High);
-                        }
+    for(unsigned long v=0;v<ntfsats.size();++v){//one phenotype table per Ntfsat, shared by all the omegas
+        NtfsatPerAllele=ntfsats[v];
+        NtfsatDeltaGs(NtfsatPerAllele,deltaG1dosage,deltaG1);
+        std::string NtfsatDesignator=outputSummaryFileDesignator;
+        if(ntfsatsListed){//one set of result files per Ntfsat
+            std::stringstream nn; nn<<NtfsatPerAllele;
+            NtfsatDesignator.replace(NtfsatDesignator.find(NtfsatTag),NtfsatTag.length(),"_Ntf"+nn.str());
+            logger.Log(logInfo,"Ntfsat = "+nn.str()+" ("+std::to_string(v+1)+" of "+std::to_string(ntfsats.size())
+                        +"), deltaG1dosage = "+std::to_string((double)deltaG1dosage)+", deltaG1 = "+std::to_string((double)deltaG1));}
+        minmaxIndiv.CalculateMinMaxExpression(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,
+                minExpression,maxExpression,modelToRun);
+        if(RunOptionValue(runOptions,"phenotype-cache","").length()>0){
+                std::string cacheDir=RunOptionValue(runOptions,"phenotype-cache","");
+                if(phenotypeTable.LoadOrBuild(cacheDir,bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1)==-1){
+                    logger.Log(logWarning,"can't use phenotype table cache in "+cacheDir+"; using a private copy");}
+                if(phenotypeTable.isMapped()){
+                    logger.Log(logDebug,"phenotype table mapped from "+cacheDir);}
+                }
+            else{
+                phenotypeTable.Build(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1);}
+        if(phenotypeIndex.enabled_){
+            phenotypeIndex.Build(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression);}
+
+        for(unsigned long w=0;w<omegas.size();++w){//the phenotype table & min/max expression are shared by all of these
+            omega=omegas[w];
+            std::string omegaDesignator=NtfsatDesignator;
+            if(omegasListed){//one set of result files per omega
+                std::stringstream oo; oo<<omega;
+                if(omegaTag.length()==0){
+                        omegaDesignator+="_o"+oo.str();}
                     else{
-                        MaximizeUsingBitstrings(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
-                            Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,summariesOfSolutions,
-                                outputfileSolutionSummaries,splitSinglePoptRun,tf0Low,tf0High);}
-            }//switch modelToRun
+                        omegaDesignator.replace(omegaDesignator.find(omegaTag),omegaTag.length(),"_o"+oo.str());}
+                logger.Log(logInfo,"omega = "+oo.str()+" ("+std::to_string(w+1)+" of "+std::to_string(omegas.size())+")");}
+            outputfileSolutionSummariesName="fitnessOverdomSummaryTable"+omegaDesignator+modeDesignator+".txt";
+            sweepProgress.statusFileName_="fitnessOverdomStatus"+omegaDesignator+modeDesignator+".txt";
+            if(!sharedLog.isOpen()){
+                outputfileSolutionSummaries.open(outputfileSolutionSummariesName.c_str(),std::fstream::out);//overwrites
+                outputfileSolutionSummaries.close();
+                outputfileSolutionSummaries.open(outputfileSolutionSummariesName.c_str(),std::fstream::app);
+                if(!printSeparateHeaderFile){
+                    summariesOfSolutions.PrintHeaderLine(outputfileSolutionSummaries,itemsColumn);}
+                }
+            std::fstream outputfilePrevalence;
+            if(prevalenceSampler.enabled_){
+                outputfilePrevalence.open(("polymorphismPrevalence"+omegaDesignator+".txt").c_str(),std::fstream::out);//overwrites
+                prevalenceSampler.PrintHeaderLine(outputfilePrevalence);}
+            std::fstream outputfileHetCodeMaxima, outputfileNearOptimal;
+            if(hetCodeMaxima.enabled_){
+                outputfileHetCodeMaxima.open(("hetCodeMaxima"+omegaDesignator+modeDesignator+".txt").c_str(),std::fstream::out);//overwrites
+                hetCodeMaxima.PrintHeaderLine(outputfileHetCodeMaxima);}
+            if(nearOptimal.enabled_){
+                outputfileNearOptimal.open(("nearOptimal"+omegaDesignator+modeDesignator+".txt").c_str(),std::fstream::out);//overwrites
+                nearOptimal.PrintHeaderLine(outputfileNearOptimal,summariesOfSolutions);}
+            BinarySummaryTable binarySummary;
+            binarySummary.splitSinglePoptRun_=splitSinglePoptRun;
+            binarySummary.headerInTable_=!printSeparateHeaderFile;
+            PoptResultStore results(PoptLow,PoptHigh,PoptSteps,(refinePopt) ? 1 : PoptStepSize,splitSinglePoptRun,tf0Low,tf0High);
+            std::vector<int> PoptQueue;//the coarse grid, then (when refining) the midpoints that still straddle a transition
+            for(int i=PoptLow;i<=PoptHigh;i+=PoptStepSize){//+=5 normally
+                PoptQueue.push_back(i);}
+            while(PoptQueue.size()>0){
+                for(unsigned long q=0;q<PoptQueue.size();++q){
+                    int i=PoptQueue[q];
+                    long double Popt = (long double)i/(long double)PoptSteps;
+                    FitnessMaximaSolutionSets poptSummaries(splitSinglePoptRun,tf0Low,tf0High);//only this Popt, so no scans past the others
+                    if(hetCodeMaxima.enabled_ && hetCodeMaxima.Reset()==-1){
+                        logger.Log(logError,"--het-code-maxima can't hold wBar to "+std::to_string(decimalDigitsToRound)+" decimal places",true);
+                        return 1;}
+                    if(nearOptimal.enabled_){
+                        nearOptimal.Reset();}
+                    if(prevalenceSampler.enabled_){
+                            EstimatePrevalenceBySampling(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                Popt,omega,poptSummaries,outputfileSolutionSummaries,outputfilePrevalence);
+                            }
+                        else if(heuristicSearch.enabled_){
+                            MaximizeUsingHeuristicSearch(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                Popt,omega,poptSummaries,outputfileSolutionSummaries);
+                            }
+                        else{
+                            switch(modelToRun){
+                                case dosageOnly:
+                                    MaximizeUsingBitstringsDosageOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                        Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
+                                        poptSummaries,outputfileSolutionSummaries);
+                                    break;
+                                case tfProductOnly:
+                                    MaximizeUsingBitstringsTFproductOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                        Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
+                                        poptSummaries,outputfileSolutionSummaries);
+                                    break;
+                                case cisOnly:
+                                    MaximizeUsingBitstringsCisOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                        Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
+                                        poptSummaries,outputfileSolutionSummaries);
+                                    break;
+                                case tfOnly: //dosage & product; always uses threads
+                                    MaximizeUsingBitstringsTFOnly(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                        Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
+                                        poptSummaries,outputfileSolutionSummaries);
+                                    break;
+                                default: //allSites
+                                    if(mismatchClasses.enabled_){
+                                            MaximizeUsingMismatchClasses(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,
+                                                minExpression,maxExpression,Popt,omega,poptSummaries,outputfileSolutionSummaries,
+                                                splitSinglePoptRun,tf0Low,tf0High);
+                                            }
+                                        else if(runUsingThreads){
+                                            MaximizeUsingBitstringsThreadableAllCis(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,
+                                                minExpression,maxExpression,Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,
+                                                poptSummaries,outputfileSolutionSummaries,splitSinglePoptRun,tf0Low,tf0High);
+                                            }
+                                        else{
+                                            MaximizeUsingBitstrings(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                                                Popt,omega,wBarMaxAllSolutions,outputfileAllSolutions,saveAllSolutions,poptSummaries,
+                                                    outputfileSolutionSummaries,splitSinglePoptRun,tf0Low,tf0High);}
+                                }//switch modelToRun
+                            }
+                    if(nearOptimal.enabled_){//before --validate-search, which would count its g'types again
+                        nearOptimal.Write(outputfileNearOptimal,Popt);}
+                    if(heuristicSearch.validating_){//search too, and compare with what the enumeration found
+                        FitnessMaximaSolutionSets searchSummaries(splitSinglePoptRun,tf0Low,tf0High);
+                        std::stringstream searchRows;//not written anywhere
+                        MaximizeUsingHeuristicSearch(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,
+                            Popt,omega,searchSummaries,searchRows);
+                        logger.Log(logInfo,heuristicSearch.Validate(poptSummaries,searchSummaries,Popt));}
+                    if(hetCodeMaxima.enabled_){
+                        simulationSettings simSet(bitstringLen,NtfsatPerAllele,deltaG1dosage,deltaG1,minExpression,maxExpression,Popt,omega);
+                        hetCodeMaxima.Write(outputfileHetCodeMaxima,simSet);}
+                    results.Store(i,poptSummaries);
+                    if(saveAllSolutions){
+                        wBarMaxAllSolutions.FinishPopt(allSolutionsWriter,Popt,omega,(double)NtfsatPerAllele);}
+                    if(saveBinarySummary){//checkpoint: the whole table so far, after every Popt
+                        binarySummary.AppendRows(poptSummaries,Popt);
+                        if(binarySummary.Write(outputfileSolutionSummariesName.substr(0,outputfileSolutionSummariesName.length()-4)+".bin")==-1){
+                            logger.Log(logError,"couldn't write the binary summary table for Popt="+std::to_string((double)Popt),true);}
+                        }
+                    if(sharedLog.isOpen()){
+                        SharedResultsRecord rec;
+                        rec.PoptIndex_=i; rec.PoptSteps_=PoptSteps;
+                        rec.startingTF0val_=tf0Low; rec.endTF0val_=tf0High; rec.splitSinglePoptRun_=splitSinglePoptRun;
+                        rec.wBarMax_=(double)poptSummaries.wBarMax(Popt);
+                        std::stringstream rows;
+                        poptSummaries.PrintDataByPopt(rows,Popt);
+                        rec.rows_=rows.str();
+                        if(sharedLog.Append(rec)==-1){
+                            logger.Log(logError,"couldn't append Popt="+std::to_string((double)Popt)+" to the shared results log",true);}
+                        }
 
 
-        std::string *elapsed=timer.HMS_elapsed();
-        coutLock.lock(); std::cout<<"elapsed = "<<*elapsed<<std::endl; coutLock.unlock();
-        delete elapsed;elapsed=NULL;
-        }
+                    std::string *elapsed=timer.HMS_elapsed();
+                    RunStatistics runStats=CollectRunStatistics();
+                    std::stringstream report;
+                    report<<"elapsed = "<<*elapsed<<std::endl; runStats.Print(report);
+                    if(phaseProfilingEnabled){
+                        PhaseProfile phaseProfile=CollectPhaseProfile();
+                        report<<"phase times (summed over threads):"<<std::endl;
+                        phaseProfile.Print(report);}
+                    std::string reportStr=report.str();
+                    reportStr.pop_back();//Log adds the last newline
+                    logger.Log(logInfo,reportStr);
+                    traceRecorder.Flush(threadTraceBuffer.events_);
+                    delete elapsed;elapsed=NULL;
+                    }//q
+                PoptQueue.clear();
+                if(refinePopt && results.RefinementPoints(PoptResolution,PoptQueue)>0){
+                    logger.Log(logInfo,"refining "+std::to_string(PoptQueue.size())+" Popt interval(s) with a change of solution");}
+                }//PoptQueue
+            outputfileSolutionSummaries.close();
+            outputfilePrevalence.close();
+            outputfileHetCodeMaxima.close();
+            outputfileNearOptimal.close();
+            }//omegas
+        }//ntfsats
+    if(heuristicSearch.validating_){
+        logger.Log(logInfo,heuristicSearch.ValidationSummary());}
+    traceRecorder.Close(threadTraceBuffer.events_);
+    sharedLog.Close();
+    logger.Stop();
+    allSolutionsWriter.Stop();
     outputfileAllSolutions.close();
-    outputfileSolutionSummaries.close();
     delete [] outputfileAllSolutionsNameStr;
-    delete [] outputfileSolutionSummariesNameStr;
-    outputfileAllSolutionsNameStr=outputfileSolutionSummariesNameStr=NULL;
+    outputfileAllSolutionsNameStr=NULL;
     return 0;
 }//main
 